@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "cht.hpp"
+#include "convenience/builtins.hpp"
+#include "pgm.hpp"
+#include "quality.hpp"
+#include "rmi.hpp"
+#include "rs.hpp"
+#include "ts.hpp"
+
+namespace learned_hashing {
+/**
+ * Options steering AutoLearnedHash's configuration selection.
+ *
+ * The defaults are not deterministic: latency scores include measured hash
+ * times and candidates are skipped once the time budget ran out, both of
+ * which depend on the machine and its load. Set measure = false and an
+ * unlimited time_budget for a selection that only depends on the sample,
+ * seed and the remaining options
+ */
+struct AutoTuneOptions {
+  enum class Metric {
+    /// minimize estimated lookup latency (model evaluation + probing)
+    Latency,
+    /// minimize collisions when hashing into a table with one slot per key
+    Collisions,
+  };
+
+  Metric metric = Metric::Latency;
+
+  /// maximum (estimated) byte_size() of the final hash function
+  size_t byte_budget = std::numeric_limits<size_t>::max();
+
+  /// amount of sample keys candidates are trained and evaluated on
+  size_t subsample_size = 250'000;
+
+  /// candidates are no longer evaluated once tuning took this long. The
+  /// first candidate is always evaluated. Wall clock dependent, see above
+  std::chrono::milliseconds time_budget{2000};
+
+  /// seeds subsample selection and measurement query order
+  std::uint64_t seed = 42;
+
+  /// time hash computations on the subsample. Disabling this makes latency
+  /// selection purely model based, i.e., independent of timing noise, but
+  /// blind to differences in model evaluation cost
+  bool measure = true;
+};
+
+/// Outcome of AutoLearnedHash's configuration selection
+struct AutoTuneReport {
+  struct Candidate {
+    std::string name;
+    /// whether the candidate was evaluated before the time budget ran out
+    bool evaluated = false;
+    /// byte_size() extrapolated to the full sample
+    size_t estimated_byte_size = 0;
+    bool within_budget = false;
+    /// collisions per key on the held-out half of the subsample
+    double collision_rate = 0;
+    double expected_probes = 0;
+    /// measured ns per hash computation on the subsample, 0 if not measured
+    double measured_ns = 0;
+    /// estimated lookup latency in ns
+    double estimated_ns = 0;
+    /// value minimized by the selection, i.e., estimated_ns or collision_rate
+    double score = 0;
+  };
+
+  std::vector<Candidate> candidates;
+  size_t selected = 0;
+  size_t subsample_size = 0;
+  std::chrono::nanoseconds tuning_time{0};
+  bool time_budget_exceeded = false;
+};
+
+/// Configurations considered by AutoLearnedHash by default
+template <class Data>
+using DefaultAutoCandidates =
+    std::tuple<RMIHash<Data, 100>, RMIHash<Data, 10'000>,
+               RMIHash<Data, 1'000'000>, RadixSplineHash<Data, 18, 4>,
+               RadixSplineHash<Data, 18, 16>, RadixSplineHash<Data, 18, 128>,
+               TrieSplineHash<Data, 16>, PGMHash<Data, 16>,
+               PGMHash<Data, 128>, CHTHash<Data, 16>>;
+
+/**
+ * Learned hash function that picks the best of several candidate
+ * configurations (e.g., RMIHash<..., 10'000> vs. RadixSplineHash<..., 16>)
+ * for the given sample, byte budget and target metric.
+ *
+ * Candidates are trained on a seeded random subsample of the sample and
+ * scored with a lightweight cost model:
+ *  - byte size is extrapolated linearly from training on half and all of
+ *    the subsample
+ *  - collision behaviour is evaluated on every other subsample key for a
+ *    model trained on the remaining keys, i.e., on unseen keys as is the
+ *    case when training on a sample of the full dataset
+ *  - lookup latency is the measured time per hash on the subsample, plus
+ *    the additional cache miss latency of the extrapolated model size and
+ *    the cost of additional probes in a linear probing table
+ *
+ * The winner is retrained on the entire sample. Ties are broken by byte size
+ * and then candidate order. Selection is only deterministic given the sample
+ * and seed if measurements are disabled and the time budget is unlimited,
+ * which are not the defaults (see AutoTuneOptions).
+ *
+ * @tparam Candidates std::tuple of hash function configurations
+ */
+template <class Data, class Candidates = DefaultAutoCandidates<Data>>
+class AutoLearnedHash {
+  template <class Tuple>
+  struct variant_of;
+  template <class... Ts>
+  struct variant_of<std::tuple<Ts...>> {
+    using type = std::variant<Ts...>;
+  };
+  using Variant = typename variant_of<Candidates>::type;
+
+  /// rough load latency for a random access into a structure of given size
+  static double access_latency_ns(const size_t bytes) {
+    if (bytes <= 32 * 1024) return 1.0;
+    if (bytes <= 1024 * 1024) return 4.0;
+    if (bytes <= 32 * 1024 * 1024) return 15.0;
+    return 80.0;
+  }
+
+  /// additional probes in linear probing tables mostly hit the same or the
+  /// next cache line
+  static constexpr double additional_probe_ns = 2.0;
+
+  Variant fn;
+  AutoTuneReport report;
+
+ public:
+  AutoLearnedHash() = default;
+
+  template <class RandomIt>
+  AutoLearnedHash(const RandomIt &sample_begin, const RandomIt &sample_end,
+                  const size_t full_size,
+                  const AutoTuneOptions &options = {}) {
+    train(sample_begin, sample_end, full_size, options);
+  }
+
+  /// [sample_begin, sample_end) must be sorted
+  template <class RandomIt>
+  void train(const RandomIt &sample_begin, const RandomIt &sample_end,
+             const size_t full_size, const AutoTuneOptions &options = {}) {
+    const auto start = std::chrono::steady_clock::now();
+    const size_t sample_size = std::distance(sample_begin, sample_end);
+    if (sample_size == 0) throw std::runtime_error("sample must not be empty");
+
+    // std::sample preserves order, i.e., the subsample is sorted
+    std::mt19937_64 rng(options.seed);
+    std::vector<Data> subsample;
+    subsample.reserve(std::min(sample_size, options.subsample_size));
+    std::sample(sample_begin, sample_end, std::back_inserter(subsample),
+                std::max<size_t>(2, options.subsample_size), rng);
+
+    // every other key to train on, the keys in between are held out
+    std::vector<Data> half, held_out;
+    half.reserve(subsample.size() / 2 + 1);
+    held_out.reserve(subsample.size() / 2);
+    for (size_t i = 0; i < subsample.size(); i++)
+      (i % 2 == 0 ? half : held_out).push_back(subsample[i]);
+    // a single sample key can only be evaluated on itself
+    if (held_out.empty()) held_out = half;
+
+    std::vector<Data> queries(subsample);
+    std::shuffle(queries.begin(), queries.end(), rng);
+
+    report = AutoTuneReport{};
+    report.subsample_size = subsample.size();
+    report.candidates.resize(std::tuple_size_v<Candidates>);
+
+    const auto evaluate = [&]<size_t I>(std::integral_constant<size_t, I>) {
+      using Candidate = std::tuple_element_t<I, Candidates>;
+      auto &result = report.candidates[I];
+      result.name = Candidate::name();
+
+      if (I > 0 && std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start) >
+                       options.time_budget) {
+        report.time_budget_exceeded = true;
+        return;
+      }
+      result.evaluated = true;
+
+      // byte size, extrapolated to the full sample
+      const Candidate half_fn(half.begin(), half.end(), held_out.size());
+      const Candidate sub_fn(subsample.begin(), subsample.end(),
+                             subsample.size());
+      const double half_bytes = half_fn.byte_size();
+      const double sub_bytes = sub_fn.byte_size();
+      const double growth =
+          subsample.size() > half.size()
+              ? std::max(0.0, sub_bytes - half_bytes) /
+                    static_cast<double>(subsample.size() - half.size())
+              : 0.0;
+      result.estimated_byte_size =
+          sub_bytes + growth * static_cast<double>(sample_size -
+                                                   subsample.size());
+      result.within_budget = result.estimated_byte_size <= options.byte_budget;
+
+      // collisions on keys the model was not trained on, i.e., in a table
+      // with one slot per held-out key
+      const auto quality =
+          quality::evaluate(half_fn, held_out, held_out.size(), 1);
+      result.collision_rate = static_cast<double>(quality.collisions) /
+                              static_cast<double>(held_out.size());
+      result.expected_probes = quality.linear_probing_expected_probes;
+
+      if (options.measure && options.metric == AutoTuneOptions::Metric::Latency)
+        result.measured_ns = measure(sub_fn, queries);
+
+      result.estimated_ns =
+          result.measured_ns +
+          std::max(0.0, access_latency_ns(result.estimated_byte_size) -
+                            access_latency_ns(sub_bytes)) +
+          additional_probe_ns * (result.expected_probes - 1.0);
+      result.score = options.metric == AutoTuneOptions::Metric::Latency
+                         ? result.estimated_ns
+                         : result.collision_rate;
+    };
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+      (evaluate(std::integral_constant<size_t, Is>{}), ...);
+    }(std::make_index_sequence<std::tuple_size_v<Candidates>>{});
+
+    // best candidate within budget. Falls back to the smallest candidate if
+    // none fits
+    const auto better = [&](const auto &a, const auto &b) {
+      if (a.within_budget != b.within_budget) return a.within_budget;
+      if (!a.within_budget)
+        return a.estimated_byte_size < b.estimated_byte_size;
+      if (a.score != b.score) return a.score < b.score;
+      return a.estimated_byte_size < b.estimated_byte_size;
+    };
+    report.selected = 0;
+    for (size_t i = 1; i < report.candidates.size(); i++)
+      if (report.candidates[i].evaluated &&
+          better(report.candidates[i], report.candidates[report.selected]))
+        report.selected = i;
+
+    emplace(report.selected, sample_begin, sample_end, full_size);
+    report.tuning_time = std::chrono::steady_clock::now() - start;
+  }
+
+  forceinline size_t operator()(const Data &key) const {
+    return std::visit([&](const auto &f) -> size_t { return f(key); }, fn);
+  }
+
+  size_t byte_size() const {
+    return sizeof(*this) +
+           std::visit([](const auto &f) { return f.byte_size(); }, fn);
+  }
+
+  size_t model_count() const {
+    return std::visit([](const auto &f) { return f.model_count(); }, fn);
+  }
+
+  /// details on how the configuration was selected
+  const AutoTuneReport &tuning_report() const { return report; }
+
+  /// name of the selected configuration
+  std::string selected_name() const {
+    return std::visit([](const auto &f) { return f.name(); }, fn);
+  }
+
+  static std::string name() { return "auto_learned_hash"; }
+
+ private:
+  /// fastest of three rounds of hashing all queries, in ns per hash
+  template <class Hashfn>
+  static double measure(const Hashfn &hashfn,
+                        const std::vector<Data> &queries) {
+    double best = std::numeric_limits<double>::infinity();
+    for (size_t round = 0; round < 3; round++) {
+      size_t checksum = 0;
+      const auto round_start = std::chrono::steady_clock::now();
+      for (const auto &key : queries) checksum += hashfn(key);
+      const auto round_end = std::chrono::steady_clock::now();
+
+      // prevent the compiler from eliding the loop
+      asm volatile("" : : "r"(checksum) : "memory");
+
+      const std::chrono::duration<double, std::nano> elapsed =
+          round_end - round_start;
+      best = std::min(best, elapsed.count() /
+                                static_cast<double>(queries.size()));
+    }
+    return best;
+  }
+
+  template <size_t I = 0, class RandomIt>
+  void emplace(const size_t index, const RandomIt &sample_begin,
+               const RandomIt &sample_end, const size_t full_size) {
+    if constexpr (I < std::tuple_size_v<Candidates>) {
+      if (index == I) {
+        fn.template emplace<I>(sample_begin, sample_end, full_size);
+        return;
+      }
+      emplace<I + 1>(index, sample_begin, sample_end, full_size);
+    }
+  }
+};
+}  // namespace learned_hashing
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "convenience/allocator.hpp"
+#include "convenience/builtins.hpp"
+#include "convenience/key_traits.hpp"
+
+namespace learned_hashing {
+/**
+ * Separate chaining hash table over any hash function of this library, e.g.,
+ * ChainedHashTable<Key, Payload, RMIHash<Key, 10'000>>.
+ *
+ * The bucket directory is one contiguous array whose buckets store their
+ * first entry inline, i.e., a lookup of a key without collisions touches a
+ * single directory slot. Further entries of a bucket are chained through
+ * entries allocated from an arena of fixed size slabs: allocating an entry
+ * is a bump of the arena's cursor, entries never move (slabs are not
+ * reallocated as the arena grows) and chains are linked by 32 bit indices
+ * instead of pointers. Learned hash functions spread keys (almost) evenly,
+ * i.e., most chains are short and most keys are found in the directory.
+ *
+ * Entries are never erased, i.e., the arena only grows.
+ *
+ * @tparam Key unsigned integer keys
+ * @tparam Payload value type
+ * @tparam Hashfn hash function, trained with full_size = bucket count
+ * @tparam Allocator allocator of the directory & slabs, e.g.,
+ *   HugePageAllocator for large tables
+ */
+template <class Key, class Payload, class Hashfn,
+          class Allocator = std::allocator<Key>>
+class ChainedHashTable {
+  static_assert(is_unsigned_key<Key>);
+
+ public:
+  /// log2 of the amount of entries per arena slab
+  static constexpr size_t slab_bits = 12;
+
+  /// keys per batch of insert_batch() & lookup_batch(), i.e., amount of
+  /// directory slots in flight
+  static constexpr size_t batch_size = 16;
+
+ private:
+  struct Entry {
+    Key key;
+    Payload payload;
+    /// index + 1 of the next entry in the arena, 0 if this is the last entry
+    std::uint32_t next = 0;
+    /// whether the entry holds a key (only ever false for directory slots)
+    bool used = false;
+  };
+
+  using EntryAllocator = rebind_alloc_t<Allocator, Entry>;
+
+  static constexpr size_t slab_size = size_t{1} << slab_bits;
+  static constexpr size_t max_arena_size =
+      std::numeric_limits<std::uint32_t>::max();
+
+  Hashfn hashfn;
+
+  std::vector<Entry, EntryAllocator> directory;
+  std::vector<std::vector<Entry, EntryAllocator>> slabs;
+
+  size_t key_count = 0;
+  /// amount of arena entries in use
+  size_t arena_size = 0;
+
+ public:
+  ChainedHashTable() = default;
+
+  /**
+   * @param sample_begin, sample_end sorted (!) sample of the keys to train
+   *   the hash function on
+   * @param bucket_count size of the directory, i.e., the amount of keys
+   *   stored inline
+   */
+  template <class RandomIt>
+  ChainedHashTable(const RandomIt &sample_begin, const RandomIt &sample_end,
+                   const size_t bucket_count)
+      : directory(std::max<size_t>(1, bucket_count)) {
+    if (sample_begin != sample_end)
+      hashfn = Hashfn(sample_begin, sample_end, directory.size());
+  }
+
+  /**
+   * Inserts key with payload, unless key is already contained.
+   * @return whether key was inserted
+   */
+  bool insert(const Key &key, const Payload &payload) {
+    return insert_into(bucket(key), key, payload);
+  }
+
+  /**
+   * Inserts keys [first, last) with payloads starting at payloads, i.e.,
+   * equivalent to calling insert() for each key. Hashes batch_size keys at a
+   * time and prefetches their directory slots before inserting any of them.
+   * @return amount of inserted (i.e., previously not contained) keys
+   */
+  template <class KeyIt, class PayloadIt>
+  size_t insert_batch(KeyIt first, const KeyIt &last, PayloadIt payloads) {
+    size_t b[batch_size];
+    size_t inserted = 0;
+    while (first != last) {
+      auto batch_first = first;
+      size_t n = 0;
+      for (; n < batch_size && first != last; n++, ++first) {
+        b[n] = bucket(*first);
+        prefetch(&directory[b[n]], 1, 0);
+      }
+      for (size_t i = 0; i < n; i++, ++batch_first, ++payloads)
+        inserted += insert_into(b[i], *batch_first, *payloads);
+    }
+    return inserted;
+  }
+
+  /// payload of key, nullptr if key is not contained
+  forceinline const Payload *lookup(const Key &key) const {
+    return probe(bucket(key), key);
+  }
+
+  forceinline bool contains(const Key &key) const {
+    return lookup(key) != nullptr;
+  }
+
+  /**
+   * Looks up all keys in [first, last), i.e., writes lookup(key) for each key
+   * to out. Hashes batch_size keys at a time and prefetches their directory
+   * slots, then probes the inline entries and prefetches the first chain
+   * entry of each miss before walking any chain, i.e., overlaps the cache
+   * misses of a batch at both levels
+   */
+  template <class InputIt, class OutputIt>
+  void lookup_batch(InputIt first, const InputIt &last, OutputIt out) const {
+    Key keys[batch_size];
+    size_t b[batch_size];
+    const Payload *results[batch_size];
+    while (first != last) {
+      size_t n = 0;
+      for (; n < batch_size && first != last; n++, ++first) {
+        keys[n] = *first;
+        b[n] = bucket(keys[n]);
+        prefetch(&directory[b[n]], 0, 0);
+      }
+
+      // chain heads of misses, i.e., b[i] now holds the head's index + 1
+      for (size_t i = 0; i < n; i++) {
+        const auto &slot = directory[b[i]];
+        results[i] = nullptr;
+        b[i] = 0;
+        if (likely(slot.used && slot.key == keys[i])) {
+          results[i] = &slot.payload;
+        } else if (slot.next != 0) {
+          b[i] = slot.next;
+          prefetch(&entry(slot.next - 1), 0, 0);
+        }
+      }
+
+      for (size_t i = 0; i < n; i++, ++out) {
+        for (auto next = b[i]; next != 0;) {
+          const auto &e = entry(next - 1);
+          if (e.key == keys[i]) {
+            results[i] = &e.payload;
+            break;
+          }
+          next = e.next;
+        }
+        *out = results[i];
+      }
+    }
+  }
+
+  /// amount of keys
+  size_t size() const { return key_count; }
+
+  size_t bucket_count() const { return directory.size(); }
+
+  double load_factor() const {
+    return static_cast<double>(key_count) /
+           static_cast<double>(directory.size());
+  }
+
+  /// amount of keys stored in chains, i.e., not inline in the directory
+  size_t chained_count() const { return arena_size; }
+
+  /// length of the longest chain, including the inline entry
+  size_t max_chain_length() const {
+    size_t max = 0;
+    for (const auto &slot : directory) {
+      size_t length = slot.used;
+      for (auto next = slot.next; next != 0; next = entry(next - 1).next)
+        length++;
+      max = std::max(max, length);
+    }
+    return max;
+  }
+
+  size_t byte_size() const {
+    return sizeof(*this) + hashfn.byte_size() +
+           directory.size() * sizeof(Entry) +
+           slabs.size() * (sizeof(slabs[0]) + slab_size * sizeof(Entry));
+  }
+
+  static std::string name() {
+    return "chained_" + Hashfn::name() + allocator_name<Allocator>();
+  }
+
+ private:
+  forceinline size_t bucket(const Key &key) const {
+    return std::min<size_t>(hashfn(key), directory.size() - 1);
+  }
+
+  forceinline const Entry &entry(const size_t index) const {
+    return slabs[index >> slab_bits][index & (slab_size - 1)];
+  }
+  forceinline Entry &entry(const size_t index) {
+    return slabs[index >> slab_bits][index & (slab_size - 1)];
+  }
+
+  forceinline const Payload *probe(const size_t b, const Key &key) const {
+    const auto &slot = directory[b];
+    if (likely(slot.used && slot.key == key)) return &slot.payload;
+    for (auto next = slot.next; next != 0;) {
+      const auto &e = entry(next - 1);
+      if (e.key == key) return &e.payload;
+      next = e.next;
+    }
+    return nullptr;
+  }
+
+  bool insert_into(const size_t b, const Key &key, const Payload &payload) {
+    auto &slot = directory[b];
+    if (likely(!slot.used)) {
+      slot.key = key;
+      slot.payload = payload;
+      slot.used = true;
+      key_count++;
+      return true;
+    }
+    if (probe(b, key) != nullptr) return false;
+
+    // prepend to the bucket's chain
+    const size_t index = allocate_entry();
+    auto &e = entry(index);
+    e.key = key;
+    e.payload = payload;
+    e.used = true;
+    e.next = slot.next;
+    slot.next = static_cast<std::uint32_t>(index + 1);
+    key_count++;
+    return true;
+  }
+
+  /// index of a fresh arena entry
+  size_t allocate_entry() {
+    if (unlikely(arena_size == max_arena_size))
+      throw std::length_error("chained hash table arena exhausted");
+    if (unlikely(arena_size == slabs.size() * slab_size))
+      slabs.emplace_back(slab_size);
+    return arena_size++;
+  }
+};
+}  // namespace learned_hashing
@@ -1,19 +1,23 @@
 #pragma once
 
+#include <memory>
+
 #include "cht/builder.h"
 #include "cht/cht.h"
+#include "convenience/allocator.hpp"
 #include "convenience/builtins.hpp"
 #include "include/convenience/bounds.hpp"
 
 namespace learned_hashing {
-template <class Data, size_t max_error = 32, size_t num_bins = 64>
+template <class Data, size_t max_error = 32, size_t num_bins = 64,
+          class Allocator = std::allocator<Data>>
 class CHTHash {
   /// output range is scaled from [0, sample_size) to [0, full_size) via this
   /// factor
   double _out_scale_fac;
 
   /// underlying model
-  cht::CompactHistTree<Data> _cht;
+  cht::CompactHistTree<Data, Allocator> _cht;
 
  public:
   CHTHash() noexcept = default;
@@ -40,7 +44,7 @@ class CHTHash {
     for (auto it = sample_begin; it < sample_end; it++) chsb.AddKey(*it);
 
     // actually build cht
-    _cht = chsb.Finalize();
+    _cht = chsb.template Finalize<Allocator>();
   }
 
   forceinline size_t operator()(const Data &key) const {
@@ -58,7 +62,8 @@ class CHTHash {
   size_t byte_size() const { return sizeof(decltype(*this)) + model_size(); }
 
   static std::string name() {
-    return "cht_" + std::to_string(num_bins) + "_" + std::to_string(max_error);
+    return "cht_" + std::to_string(num_bins) + "_" +
+           std::to_string(max_error) + allocator_name<Allocator>();
   }
 };
 }  // namespace learned_hashing
@@ -5,6 +5,7 @@
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <memory>
 
 #include "cht.h"
 #include "common.h"
@@ -58,7 +59,8 @@ class Builder {
   }
 
   // Finalizes the construction and returns a read-only `RadixSpline`.
-  CompactHistTree<KeyType> Finalize() {
+  template <class Allocator = std::allocator<KeyType>>
+  CompactHistTree<KeyType, Allocator> Finalize() {
     // Last key needs to be equal to `max_key_`.
     assert((!curr_num_keys_) || (prev_key_ == max_key_));
 
@@ -74,9 +76,9 @@ class Builder {
       PruneAndFlatten();
     }
 
-    return CompactHistTree<KeyType>(min_key_, max_key_, curr_num_keys_,
-                                    num_bins_, log_num_bins_, max_error_,
-                                    shift_, std::move(table_));
+    return CompactHistTree<KeyType, Allocator>(
+        min_key_, max_key_, curr_num_keys_, num_bins_, log_num_bins_,
+        max_error_, shift_, std::move(table_));
   }
 
  private:
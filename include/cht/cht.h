@@ -2,15 +2,17 @@
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include <optional>
 #include <queue>
 #include <vector>
 
+#include "../convenience/allocator.hpp"
 #include "common.h"
 
 namespace cht {
 
-template <class KeyType>
+template <class KeyType, class Allocator = std::allocator<KeyType>>
 class CompactHistTree {
  public:
   CompactHistTree() = default;
@@ -25,7 +27,7 @@ class CompactHistTree {
         log_num_bins_(log_num_bins),
         max_error_(max_error),
         shift_(shift),
-        table_(std::move(table)) {}
+        table_(learned_hashing::rebind_vector<Allocator>(std::move(table))) {}
 
   // Returns a search bound [`begin`, `end`) around the estimated position.
   SearchBound GetSearchBound(const KeyType key) const {
@@ -77,7 +79,8 @@ class CompactHistTree {
   size_t max_error_;
   size_t shift_;
 
-  std::vector<unsigned> table_;
+  std::vector<unsigned, learned_hashing::rebind_alloc_t<Allocator, unsigned>>
+      table_;
 };
 
 }  // namespace cht
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace learned_hashing {
+/**
+ * Allocator that backs large allocations by 2 MB transparent huge pages
+ * (madvise(MADV_HUGEPAGE)) and optionally binds them to a NUMA node. Random
+ * lookups into large models (e.g., RMIHash second level models, RadixSpline
+ * radix tables, CHT tables) then no longer pay a TLB miss on top of the cache
+ * miss.
+ *
+ * Allocations smaller than MinHugePageBytes are served by the default
+ * allocator to avoid wasting (up to 2 MB of) memory on small structures.
+ *
+ * @tparam NumaNode node to bind memory to, or -1 to leave placement to the OS
+ * @tparam MinHugePageBytes smallest allocation to place on huge pages
+ */
+template <class T, int NumaNode = -1, size_t MinHugePageBytes = 1 << 20>
+struct HugePageAllocator {
+  // nodes are bound via a single unsigned long nodemask
+  static_assert(NumaNode < static_cast<int>(sizeof(unsigned long) * 8),
+                "NumaNode must be < 64");
+
+  using value_type = T;
+
+  static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+  template <class U>
+  struct rebind {
+    using other = HugePageAllocator<U, NumaNode, MinHugePageBytes>;
+  };
+
+  HugePageAllocator() noexcept = default;
+
+  template <class U>
+  HugePageAllocator(
+      const HugePageAllocator<U, NumaNode, MinHugePageBytes> &) noexcept {}
+
+  T *allocate(const size_t n) {
+    const size_t bytes = n * sizeof(T);
+    if (bytes < MinHugePageBytes) return std::allocator<T>().allocate(n);
+
+    void *ptr = std::aligned_alloc(huge_page_size, round_up(bytes));
+    if (ptr == nullptr) throw std::bad_alloc();
+
+#ifdef __linux__
+    // both calls are hints, i.e., failure (e.g., due to THP being disabled
+    // or a missing NUMA node) only costs performance
+    madvise(ptr, round_up(bytes), MADV_HUGEPAGE);
+    if constexpr (NumaNode >= 0) {
+      const unsigned long nodemask = 1UL << NumaNode;
+      syscall(SYS_mbind, ptr, round_up(bytes), MPOL_BIND, &nodemask,
+              sizeof(nodemask) * 8, 0);
+    }
+#endif
+
+    return static_cast<T *>(ptr);
+  }
+
+  void deallocate(T *ptr, const size_t n) noexcept {
+    if (n * sizeof(T) < MinHugePageBytes)
+      return std::allocator<T>().deallocate(ptr, n);
+    std::free(ptr);
+  }
+
+  static std::string name() {
+    return "_hugepages" +
+           (NumaNode >= 0 ? "_numa" + std::to_string(NumaNode) : "");
+  }
+
+  template <class U>
+  bool operator==(
+      const HugePageAllocator<U, NumaNode, MinHugePageBytes> &) const noexcept {
+    return true;
+  }
+
+ private:
+  static size_t round_up(const size_t bytes) {
+    return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+  }
+};
+
+/**
+ * Suffix for hash function names identifying non-default allocators, e.g.,
+ * to distinguish benchmark results
+ */
+template <class Allocator>
+std::string allocator_name() {
+  if constexpr (requires { Allocator::name(); })
+    return Allocator::name();
+  else
+    return "";
+}
+
+/// Allocator rebound to value type T
+template <class Allocator, class T>
+using rebind_alloc_t =
+    typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+/**
+ * Converts vec to a vector using Allocator (rebound to T), i.e., moves vec if
+ * the allocators match and copies its elements otherwise
+ */
+template <class Allocator, class T, class VecAllocator>
+std::vector<T, rebind_alloc_t<Allocator, T>> rebind_vector(
+    std::vector<T, VecAllocator> &&vec) {
+  if constexpr (std::is_same_v<VecAllocator, rebind_alloc_t<Allocator, T>>)
+    return std::move(vec);
+  else
+    return {vec.begin(), vec.end()};
+}
+}  // namespace learned_hashing
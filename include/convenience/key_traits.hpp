@@ -0,0 +1,73 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "builtins.hpp"
+
+namespace learned_hashing {
+/// unsigned integers, including unsigned __int128 in strict (non GNU) mode
+template <class Key>
+constexpr bool is_unsigned_key =
+    std::is_unsigned_v<Key> || std::is_same_v<Key, unsigned __int128>;
+
+/// IEEE-754 single and double precision floats
+template <class Key>
+constexpr bool is_iec559_key = std::is_floating_point_v<Key> &&
+                               std::numeric_limits<Key>::is_iec559 &&
+                               (sizeof(Key) == 4 || sizeof(Key) == 8);
+
+/**
+ * Maps keys to unsigned integers of the same width such that comparing
+ * encoded keys numerically compares the original keys, i.e., hash functions
+ * over unsigned integers (radix tables, shifts, ...) can be trained and
+ * queried on them. Encoding is branchless:
+ *  - unsigned integers are kept as is
+ *  - signed integers flip their sign bit (two's complement -> offset binary)
+ *  - IEEE-754 floats flip their sign bit if positive and all bits if negative
+ *    (sign magnitude -> offset binary). -0.0 is encoded like +0.0, since both
+ *    compare equal. NaNs are ordered above +inf (or below -inf if their sign
+ *    bit is set), i.e., hashed deterministically based on their bits
+ */
+template <class Key, class = void>
+struct KeyTraits;
+
+template <class Key>
+struct KeyTraits<Key, std::enable_if_t<is_unsigned_key<Key>>> {
+  using Encoded = Key;
+
+  static forceinline Encoded encode(const Key &key) { return key; }
+};
+
+template <class Key>
+struct KeyTraits<Key, std::enable_if_t<std::is_integral_v<Key> &&
+                                       std::is_signed_v<Key>>> {
+  using Encoded = std::make_unsigned_t<Key>;
+
+  static forceinline Encoded encode(const Key &key) {
+    return static_cast<Encoded>(key) ^
+           (static_cast<Encoded>(1) << (sizeof(Key) * 8 - 1));
+  }
+};
+
+template <class Key>
+struct KeyTraits<Key, std::enable_if_t<is_iec559_key<Key>>> {
+  using Encoded =
+      std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t>;
+
+  static forceinline Encoded encode(const Key &key) {
+    // -0.0 + 0.0 = +0.0 in the default rounding mode, other values are kept
+    const auto bits = std::bit_cast<Encoded>(static_cast<Key>(key + Key(0)));
+    constexpr auto sign_shift = sizeof(Key) * 8 - 1;
+    const Encoded mask =
+        -(bits >> sign_shift) | (static_cast<Encoded>(1) << sign_shift);
+    return bits ^ mask;
+  }
+};
+
+/// unsigned integer type keys are encoded as
+template <class Key>
+using encoded_key_t = typename KeyTraits<Key>::Encoded;
+}  // namespace learned_hashing
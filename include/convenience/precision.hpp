@@ -0,0 +1,61 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "builtins.hpp"
+
+namespace learned_hashing {
+/**
+ * Default floating point type for models over Key: the smallest type whose
+ * mantissa represents every key exactly, falling back to double for keys
+ * wider than 53 bits. E.g., float for 16 bit keys, double for 32 bit keys
+ * (float's 24 bit mantissa would merge neighbouring keys). Models over keys
+ * wider than 64 bits (unsigned __int128) only convert key differences, see
+ * is_wide_key
+ */
+template <class Key>
+using default_precision_t =
+    std::conditional_t<(std::numeric_limits<Key>::digits <=
+                        std::numeric_limits<float>::digits),
+                       float, double>;
+
+/**
+ * Whether Key is wider than 64 bits, e.g., unsigned __int128 for UUIDs or
+ * composite (tenant, id) keys. Converting such keys to a floating point type
+ * drops all but their most significant bits, i.e., models have to interpolate
+ * relative to a nearby base key instead
+ */
+template <class Key>
+constexpr bool is_wide_key = std::numeric_limits<Key>::digits > 64;
+
+/// std::bit_width that also supports keys wider than 64 bits
+template <class Key>
+constexpr size_t key_bit_width(const Key &x) {
+  if constexpr (is_wide_key<Key>) {
+    const auto high = static_cast<std::uint64_t>(x >> 64);
+    return high != 0 ? 64 + std::bit_width(high)
+                     : std::bit_width(static_cast<std::uint64_t>(x));
+  } else {
+    return std::bit_width(x);
+  }
+}
+/**
+ * Converts a key (difference) to Precision. Converting unsigned __int128 is a
+ * comparatively slow library call, i.e., wide keys are converted as two 64 bit
+ * halves instead. The result may differ from a correctly rounded conversion
+ * in its last bit
+ */
+template <class Precision, class Key>
+forceinline Precision to_precision(const Key &x) {
+  if constexpr (is_wide_key<Key>)
+    return static_cast<Precision>(static_cast<std::uint64_t>(x >> 64)) *
+               static_cast<Precision>(0x1p64) +
+           static_cast<Precision>(static_cast<std::uint64_t>(x));
+  else
+    return static_cast<Precision>(x);
+}
+}  // namespace learned_hashing
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "builtins.hpp"
+
+namespace learned_hashing {
+namespace simd {
+/**
+ * Counts the elements in [data, data + N) that are smaller than key using
+ * vector compares & popcount, i.e., without branching on the data. For
+ * sorted data, this is the offset of the first element >= key.
+ *
+ * Falls back to a (branchless) scalar loop if no suitable instruction set is
+ * available for Key.
+ *
+ * @tparam N amount of elements to compare. N * sizeof(Key) must be a
+ *    multiple of the cache line size (64 bytes)
+ */
+template <size_t N, class Key>
+forceinline size_t count_less(const Key *data, const Key key) {
+  static_assert((N * sizeof(Key)) % 64 == 0,
+                "N must span a multiple of full cache lines");
+  size_t cnt = 0;
+
+  if constexpr (std::is_unsigned_v<Key> && sizeof(Key) == 8) {
+#if defined(__AVX512F__)
+    const auto k = _mm512_set1_epi64(key);
+    for (size_t i = 0; i < N; i += 8)
+      cnt += std::popcount(static_cast<unsigned>(_mm512_cmplt_epu64_mask(
+          _mm512_loadu_si512(reinterpret_cast<const void *>(data + i)), k)));
+    return cnt;
+#elif defined(__AVX2__)
+    // AVX2 only offers signed compares -> flip sign bit on both sides
+    const auto sign = _mm256_set1_epi64x(0x8000000000000000LL);
+    const auto k = _mm256_xor_si256(_mm256_set1_epi64x(key), sign);
+    for (size_t i = 0; i < N; i += 4) {
+      const auto v = _mm256_xor_si256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)),
+          sign);
+      cnt += std::popcount(static_cast<unsigned>(
+          _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, v)))));
+    }
+    return cnt;
+#endif
+  }
+
+  if constexpr (std::is_unsigned_v<Key> && sizeof(Key) == 4) {
+#if defined(__AVX512F__)
+    const auto k = _mm512_set1_epi32(key);
+    for (size_t i = 0; i < N; i += 16)
+      cnt += std::popcount(static_cast<unsigned>(_mm512_cmplt_epu32_mask(
+          _mm512_loadu_si512(reinterpret_cast<const void *>(data + i)), k)));
+    return cnt;
+#elif defined(__AVX2__)
+    // AVX2 only offers signed compares -> flip sign bit on both sides
+    const auto sign = _mm256_set1_epi32(0x80000000);
+    const auto k = _mm256_xor_si256(_mm256_set1_epi32(key), sign);
+    for (size_t i = 0; i < N; i += 8) {
+      const auto v = _mm256_xor_si256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)),
+          sign);
+      cnt += std::popcount(static_cast<unsigned>(
+          _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, v)))));
+    }
+    return cnt;
+#endif
+  }
+
+  for (size_t i = 0; i < N; i++) cnt += data[i] < key;
+  return cnt;
+}
+
+/// amount of elements that scan_lower_bound might read past the result. Arrays
+/// scanned via scan_lower_bound must be padded with this many sentinels
+template <class Key>
+constexpr size_t scan_padding = 64 / sizeof(Key) - 1;
+
+/**
+ * Returns the index of the first element >= key, scanning one cache line worth
+ * of elements at a time via count_less. Contrary to a scalar linear search,
+ * this only branches once per cache line.
+ *
+ * Requires that [data, ...) is sorted, contains an element >= key and that
+ * scan_padding<Key> elements past that element may be read
+ */
+template <class Key>
+forceinline size_t scan_lower_bound(const Key *data, const Key key) {
+  constexpr size_t N = 64 / sizeof(Key);
+
+  size_t pos = 0;
+  while (true) {
+    const size_t cnt = count_less<N>(data + pos, key);
+    pos += cnt;
+    if (likely(cnt < N)) return pos;
+  }
+}
+
+/**
+ * Bitmask of the positions i \in [0, N) with tags[i] == tag, i.e., compares N
+ * one byte tags (fingerprints) at once, e.g., to find candidate slots of a
+ * hash table bucket without comparing full keys.
+ *
+ * Reads 8 (N <= 8) or 16 bytes from tags, i.e., tags must be padded
+ *
+ * @tparam N amount of tags, at most 16
+ */
+template <size_t N>
+forceinline std::uint32_t match_tags(const std::uint8_t *tags,
+                                     const std::uint8_t tag) {
+  static_assert(N <= 16, "at most 16 tags are supported");
+  constexpr std::uint32_t valid = (1U << N) - 1;
+
+#if defined(__SSE2__)
+  const auto t = _mm_set1_epi8(static_cast<char>(tag));
+  if constexpr (N <= 8) {
+    const auto v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(tags));
+    return static_cast<std::uint32_t>(
+               _mm_movemask_epi8(_mm_cmpeq_epi8(v, t))) &
+           valid;
+  } else {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags));
+    return static_cast<std::uint32_t>(
+               _mm_movemask_epi8(_mm_cmpeq_epi8(v, t))) &
+           valid;
+  }
+#endif
+
+  std::uint32_t mask = 0;
+  for (size_t i = 0; i < N; i++)
+    mask |= static_cast<std::uint32_t>(tags[i] == tag) << i;
+  return mask;
+}
+
+/**
+ * Copies a full cache line from src to the 64 byte aligned dst, bypassing the
+ * cache if possible (non-temporal stores), i.e., without reading dst's cache
+ * line first. Call stream_fence() before other threads read dst
+ */
+inline void stream_line(void *dst, const void *src) {
+#if defined(__AVX512F__)
+  _mm512_stream_si512(reinterpret_cast<__m512i *>(dst),
+                      _mm512_loadu_si512(src));
+#elif defined(__AVX__)
+  const auto *s = reinterpret_cast<const __m256i *>(src);
+  auto *d = reinterpret_cast<__m256i *>(dst);
+  _mm256_stream_si256(d, _mm256_loadu_si256(s));
+  _mm256_stream_si256(d + 1, _mm256_loadu_si256(s + 1));
+#else
+  std::memcpy(dst, src, 64);
+#endif
+}
+
+/// orders preceding stream_line() stores before subsequent stores
+inline void stream_fence() {
+#if defined(__AVX__)
+  _mm_sfence();
+#endif
+}
+}  // namespace simd
+}  // namespace learned_hashing
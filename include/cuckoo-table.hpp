@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+#include "convenience/key_traits.hpp"
+#include "convenience/simd.hpp"
+#include "hybrid.hpp"
+
+namespace learned_hashing {
+/**
+ * Bucketized cuckoo hash table whose primary bucket is chosen by a (learned)
+ * hash function and whose alternate bucket by a classical hash (murmur
+ * finalizer), e.g., CuckooHashTable<Key, Payload, RMIHash<Key, 10'000>>.
+ *
+ * A learned primary hash spreads keys (almost) evenly across buckets, i.e.,
+ * most keys reside in their primary bucket and few keys need to be displaced
+ * to their alternate bucket. The classical alternate hash keeps the table
+ * fillable beyond 95% load even where the model is inaccurate. Keys that
+ * could not be placed after max_kicks displacements go to a small stash.
+ *
+ * Each bucket is one cache line holding slot_count keys and a one byte tag
+ * (fingerprint) per slot, i.e., a probe compares all tags of a bucket at
+ * once (simd::match_tags) and only compares keys whose tags match. Payloads
+ * are stored separately from keys.
+ *
+ * @tparam Key unsigned integer keys
+ * @tparam Payload value type
+ * @tparam Hashfn primary hash function, trained with full_size = bucket count
+ * @tparam SlotCount keys per bucket, at most 8
+ */
+template <class Key, class Payload, class Hashfn,
+          size_t SlotCount = std::clamp<size_t>((64 - 8) / sizeof(Key), 4, 8)>
+class CuckooHashTable {
+  static_assert(is_unsigned_key<Key>);
+  static_assert(SlotCount > 0 && SlotCount <= 8);
+
+ public:
+  static constexpr size_t slot_count = SlotCount;
+
+  /// displacements per insert before the key is moved to the stash
+  static constexpr size_t max_kicks = 500;
+
+  /// keys per batch of lookup_batch(), i.e., amount of buckets in flight
+  static constexpr size_t batch_size = 16;
+
+ private:
+  /// tags (0 = empty slot) followed by keys, i.e., one cache line for 64 bit
+  /// keys
+  struct alignas(64) Bucket {
+    std::uint8_t tags[8] = {};
+    Key keys[SlotCount];
+  };
+
+  /// buckets & tag of a key
+  struct Hashes {
+    size_t primary, alternate;
+    std::uint8_t tag;
+  };
+
+  Hashfn hashfn;
+
+  std::vector<Bucket> buckets;
+  std::vector<Payload> payloads;
+  std::vector<std::pair<Key, Payload>> stash;
+
+  size_t key_count = 0;
+  size_t displacements = 0;
+  std::uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+ public:
+  CuckooHashTable() = default;
+
+  /**
+   * @param sample_begin, sample_end sorted (!) sample of the keys to train
+   *   the hash function on
+   * @param capacity amount of key slots, i.e., capacity / slot_count buckets
+   */
+  template <class RandomIt>
+  CuckooHashTable(const RandomIt &sample_begin, const RandomIt &sample_end,
+                  const size_t capacity)
+      : buckets(std::max<size_t>(2, (capacity + SlotCount - 1) / SlotCount)),
+        payloads(buckets.size() * SlotCount) {
+    if (sample_begin != sample_end)
+      hashfn = Hashfn(sample_begin, sample_end, buckets.size());
+  }
+
+  /**
+   * Inserts key with payload, unless key is already contained.
+   * @return whether key was inserted
+   */
+  bool insert(const Key &key, const Payload &payload) {
+    const auto h = hashes(key);
+    if (find_in(h.primary, h.tag, key) != nullptr ||
+        find_in(h.alternate, h.tag, key) != nullptr ||
+        (unlikely(!stash.empty()) && find_in_stash(key) != nullptr))
+      return false;
+
+    key_count++;
+    if (place(h.primary, h.tag, key, payload) ||
+        place(h.alternate, h.tag, key, payload))
+      return true;
+
+    // random walk: evict a random slot of one of the key's buckets and move
+    // the evicted key to its other bucket, until some key finds a free slot
+    Key k = key;
+    Payload p = payload;
+    std::uint8_t tag = h.tag;
+    size_t b = next_random() & 1 ? h.primary : h.alternate;
+    for (size_t kick = 0; kick < max_kicks; kick++) {
+      const size_t slot = next_random() % SlotCount;
+      auto &bucket = buckets[b];
+      std::swap(k, bucket.keys[slot]);
+      std::swap(p, payloads[b * SlotCount + slot]);
+      std::swap(tag, bucket.tags[slot]);
+      displacements++;
+
+      const auto evicted = hashes(k);
+      b = b == evicted.primary ? evicted.alternate : evicted.primary;
+      if (place(b, tag, k, p)) return true;
+    }
+
+    stash.emplace_back(k, p);
+    return true;
+  }
+
+  /// payload of key, nullptr if key is not contained
+  forceinline const Payload *lookup(const Key &key) const {
+    return probe(hashes(key), key);
+  }
+
+  forceinline bool contains(const Key &key) const {
+    return lookup(key) != nullptr;
+  }
+
+  /**
+   * Looks up all keys in [first, last), i.e., writes lookup(key) for each key
+   * to out. Hashes batch_size keys at a time and prefetches their buckets
+   * before probing any of them, i.e., overlaps the cache misses of a batch
+   */
+  template <class InputIt, class OutputIt>
+  void lookup_batch(InputIt first, const InputIt &last, OutputIt out) const {
+    Hashes h[batch_size];
+    Key keys[batch_size];
+    while (first != last) {
+      size_t n = 0;
+      for (; n < batch_size && first != last; n++, ++first) {
+        keys[n] = *first;
+        h[n] = hashes(keys[n]);
+        prefetch(&buckets[h[n].primary], 0, 0);
+        prefetch(&buckets[h[n].alternate], 0, 0);
+      }
+      for (size_t i = 0; i < n; i++, ++out) *out = probe(h[i], keys[i]);
+    }
+  }
+
+  /// amount of keys
+  size_t size() const { return key_count; }
+
+  size_t bucket_count() const { return buckets.size(); }
+
+  size_t capacity() const { return buckets.size() * SlotCount; }
+
+  double load_factor() const {
+    return static_cast<double>(key_count) / static_cast<double>(capacity());
+  }
+
+  /// total amount of evictions during inserts
+  size_t displacement_count() const { return displacements; }
+
+  /// amount of keys that could not be placed into any bucket
+  size_t stash_size() const { return stash.size(); }
+
+  /// amount of keys residing in their primary bucket
+  size_t primary_count() const {
+    size_t count = 0;
+    for (size_t b = 0; b < buckets.size(); b++)
+      for (size_t s = 0; s < SlotCount; s++)
+        count += buckets[b].tags[s] != 0 &&
+                 bucket_of(buckets[b].keys[s]) == b;
+    return count;
+  }
+
+  size_t byte_size() const {
+    return sizeof(*this) + hashfn.byte_size() +
+           buckets.size() * sizeof(Bucket) +
+           payloads.size() * sizeof(Payload) +
+           stash.capacity() * sizeof(std::pair<Key, Payload>);
+  }
+
+  static std::string name() {
+    return "cuckoo" + std::to_string(SlotCount) + "_" + Hashfn::name();
+  }
+
+ private:
+  forceinline size_t bucket_of(const Key &key) const {
+    return std::min<size_t>(hashfn(key), buckets.size() - 1);
+  }
+
+  forceinline Hashes hashes(const Key &key) const {
+    std::uint64_t folded = static_cast<std::uint64_t>(key);
+    if constexpr (sizeof(Key) > sizeof(std::uint64_t))
+      folded ^= static_cast<std::uint64_t>(key >> 64);
+    // independent of the primary hash, even if that is murmur as well
+    const auto h = murmur_finalizer(folded ^ 0x5851F42D4C957F2DULL);
+
+    const size_t primary = bucket_of(key);
+    size_t alternate =
+        (static_cast<unsigned __int128>(h) * buckets.size()) >> 64;
+    if (unlikely(alternate == primary))
+      alternate = (primary + 1) % buckets.size();
+    // low bits are independent of the alternate bucket (high bits)
+    const auto tag =
+        static_cast<std::uint8_t>(std::max<std::uint64_t>(h & 0xFF, 1));
+    return {primary, alternate, tag};
+  }
+
+  forceinline const Payload *find_in(const size_t b, const std::uint8_t tag,
+                                     const Key &key) const {
+    const auto &bucket = buckets[b];
+    for (auto mask = simd::match_tags<SlotCount>(bucket.tags, tag); mask != 0;
+         mask &= mask - 1) {
+      const size_t slot = std::countr_zero(mask);
+      if (likely(bucket.keys[slot] == key))
+        return &payloads[b * SlotCount + slot];
+    }
+    return nullptr;
+  }
+
+  const Payload *find_in_stash(const Key &key) const {
+    for (const auto &[k, p] : stash)
+      if (k == key) return &p;
+    return nullptr;
+  }
+
+  forceinline const Payload *probe(const Hashes &h, const Key &key) const {
+    if (const auto *p = find_in(h.primary, h.tag, key); likely(p != nullptr))
+      return p;
+    if (const auto *p = find_in(h.alternate, h.tag, key); p != nullptr)
+      return p;
+    if (unlikely(!stash.empty())) return find_in_stash(key);
+    return nullptr;
+  }
+
+  /// stores key in a free slot of bucket b, if there is one
+  bool place(const size_t b, const std::uint8_t tag, const Key &key,
+             const Payload &payload) {
+    auto &bucket = buckets[b];
+    const auto free = simd::match_tags<SlotCount>(bucket.tags, 0);
+    if (free == 0) return false;
+    const size_t slot = std::countr_zero(free);
+    bucket.tags[slot] = tag;
+    bucket.keys[slot] = key;
+    payloads[b * SlotCount + slot] = payload;
+    return true;
+  }
+
+  /// xorshift64
+  std::uint64_t next_random() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+  }
+};
+}  // namespace learned_hashing
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include "convenience/builtins.hpp"
+
+namespace learned_hashing {
+/// Thresholds of DriftMonitor's retraining signal
+struct DriftOptions {
+  /// amount of sampled hash values required before signalling, i.e., the
+  /// expected per bucket count is min_samples / bucket count
+  size_t min_samples = 1 << 13;
+
+  /// signal once the (bias corrected) KL divergence of the sampled output
+  /// distribution from the uniform distribution exceeds this many nats
+  double max_kl_divergence = 0.1;
+
+  /// signal once any bucket holds more than this many times its expected
+  /// share of the sampled hash values
+  double max_load = 4.0;
+
+  /// halve all bucket counts every decay_window sampled hash values, i.e.,
+  /// the monitor forgets old samples at a constant rate and stays sensitive
+  /// to new drift no matter how long it ran. 0 disables decay, i.e., counts
+  /// only restart on reset()
+  size_t decay_window = 1 << 16;
+};
+
+/// Output distribution observed by a DriftMonitor
+struct DriftStats {
+  /// amount of sampled hash values since the last reset, with older samples
+  /// decayed (see DriftOptions::decay_window)
+  size_t sampled = 0;
+
+  /// Kullback-Leibler divergence (in nats) of the sampled bucket distribution
+  /// from the uniform distribution, minus the divergence expected from
+  /// sampling noise alone. Approximately 0 as long as output is uniform
+  double kl_divergence = 0;
+
+  /// load of the fullest bucket relative to the expected (uniform) load
+  double max_load = 0;
+
+  /// whether the hash function should be retrained on fresh keys
+  bool needs_retrain = false;
+};
+
+/**
+ * Lightweight online detection of distribution drift, i.e., keys that no
+ * longer fit the distribution a (learned) hash function was trained on.
+ *
+ * A trained learned hash function approximates the keys' CDF, i.e., spreads
+ * keys uniformly across its output range [0, full_size). The monitor splits
+ * the output range into 2^NumBucketBits equally wide buckets and counts
+ * sampled hash values per bucket. Keys from a different distribution pile up
+ * in few buckets, which is detected as divergence from uniform output.
+ *
+ * Sampling is key based: a key is sampled iff the top SampleBits bits of its
+ * fibonacci hash are 0, i.e., 1 in 2^SampleBits keys. Unsampled keys only pay
+ * for a multiplication and a (well predicted) branch. Sampled keys increment
+ * a relaxed atomic counter, i.e., record() may be called concurrently.
+ * Counts decay every DriftOptions::decay_window samples (concurrent records
+ * during a decay may be lost, which only adds noise).
+ *
+ * Note that lookups of the same key are sampled repeatedly, i.e., skewed
+ * access patterns appear as drift. Monitor inserted keys (or uniformly
+ * accessed ones) to detect drift of the keyset itself. Repeated lookups also
+ * add noise beyond the bias correction of DriftStats::kl_divergence, hence
+ * the conservative default thresholds of DriftOptions.
+ *
+ * @tparam NumBucketBits log2 of the amount of buckets
+ * @tparam SampleBits log2 of the inverse sampling rate
+ */
+template <size_t NumBucketBits = 8, size_t SampleBits = 6>
+class DriftMonitor {
+  static_assert(SampleBits < 64);
+  static constexpr size_t bucket_count = 1ULL << NumBucketBits;
+
+  std::array<std::atomic<std::uint32_t>, bucket_count> counts{};
+  /// amount of sampled hash values since the last decay
+  std::atomic<size_t> since_decay{0};
+
+  /// maps hash values to buckets
+  double bucket_scale = 0;
+
+  DriftOptions options;
+
+ public:
+  DriftMonitor() = default;
+
+  explicit DriftMonitor(const size_t full_size, DriftOptions options = {})
+      : options(options) {
+    reset(full_size);
+  }
+
+  /// clears all counters, e.g., after retraining with a new output range.
+  /// Must not be called concurrently with record()
+  void reset(const size_t full_size) {
+    bucket_scale =
+        static_cast<double>(bucket_count) / std::max<size_t>(full_size, 1);
+    for (auto &count : counts) count.store(0, std::memory_order_relaxed);
+    since_decay.store(0, std::memory_order_relaxed);
+  }
+
+  /// whether key's hash value is recorded
+  template <class Key>
+  static forceinline bool sampled(const Key &key) {
+    if constexpr (SampleBits == 0) {
+      return true;
+    } else {
+      std::uint64_t h;
+      if constexpr (std::is_integral_v<Key> ||
+                    std::is_same_v<Key, unsigned __int128>)
+        h = static_cast<std::uint64_t>(key);
+      else
+        h = std::hash<Key>{}(key);
+      return ((h * 0x9E3779B97F4A7C15ULL) >> (64 - SampleBits)) == 0;
+    }
+  }
+
+  /// records hash, i.e., hashfn(key), if key is sampled
+  template <class Key>
+  forceinline void record(const Key &key, const size_t hash) {
+    if (likely(!sampled(key))) return;
+
+    const auto bucket = std::min(
+        static_cast<size_t>(static_cast<double>(hash) * bucket_scale),
+        bucket_count - 1);
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    if (unlikely(options.decay_window != 0 &&
+                 since_decay.fetch_add(1, std::memory_order_relaxed) + 1 ==
+                     options.decay_window)) {
+      for (auto &count : counts)
+        count.store(count.load(std::memory_order_relaxed) / 2,
+                    std::memory_order_relaxed);
+      since_decay.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  DriftStats stats() const {
+    DriftStats stats;
+    std::array<std::uint32_t, bucket_count> snapshot;
+    for (size_t b = 0; b < bucket_count; b++) {
+      snapshot[b] = counts[b].load(std::memory_order_relaxed);
+      stats.sampled += snapshot[b];
+    }
+    if (stats.sampled == 0) return stats;
+
+    const double n = static_cast<double>(stats.sampled);
+    const double expected = n / bucket_count;
+    double kl = 0;
+    std::uint32_t max_count = 0;
+    for (const auto count : snapshot) {
+      if (count > 0) kl += (count / n) * std::log(count / expected);
+      max_count = std::max(max_count, count);
+    }
+
+    // 2n * KL is approximately chi-square distributed with bucket_count - 1
+    // degrees of freedom for uniform output
+    stats.kl_divergence =
+        std::max(0.0, kl - static_cast<double>(bucket_count - 1) / (2 * n));
+    stats.max_load = max_count / expected;
+    stats.needs_retrain = stats.sampled >= options.min_samples &&
+                          (stats.kl_divergence > options.max_kl_divergence ||
+                           stats.max_load > options.max_load);
+    return stats;
+  }
+
+  bool needs_retrain() const { return stats().needs_retrain; }
+
+  size_t byte_size() const { return sizeof(*this); }
+};
+
+/**
+ * Wraps a hash function and monitors its output for distribution drift, see
+ * DriftMonitor. Retraining resets the monitor.
+ *
+ * @tparam Hashfn hash function to monitor
+ * @tparam NumBucketBits log2 of the amount of monitor buckets
+ * @tparam SampleBits log2 of the inverse sampling rate
+ */
+template <class Hashfn, size_t NumBucketBits = 8, size_t SampleBits = 6>
+class MonitoredHash {
+  Hashfn fn;
+
+  /// recorded from the const hashing interface
+  mutable DriftMonitor<NumBucketBits, SampleBits> monitor;
+
+ public:
+  MonitoredHash() = default;
+
+  template <class RandomIt>
+  MonitoredHash(const RandomIt &sample_begin, const RandomIt &sample_end,
+                const size_t full_size, const DriftOptions options = {})
+      : monitor(full_size, options) {
+    train(sample_begin, sample_end, full_size);
+  }
+
+  template <class RandomIt>
+  void train(const RandomIt &sample_begin, const RandomIt &sample_end,
+             const size_t full_size) {
+    fn.train(sample_begin, sample_end, full_size);
+    monitor.reset(full_size);
+  }
+
+  template <class Key>
+  forceinline size_t operator()(const Key &key) const {
+    const size_t hash = fn(key);
+    monitor.record(key, hash);
+    return hash;
+  }
+
+  DriftStats drift_stats() const { return monitor.stats(); }
+
+  bool needs_retrain() const { return monitor.needs_retrain(); }
+
+  size_t model_count() const { return fn.model_count(); }
+
+  size_t byte_size() const { return fn.byte_size() + monitor.byte_size(); }
+
+  static std::string name() {
+    return "monitored" + std::to_string(NumBucketBits) + "_" +
+           std::to_string(SampleBits) + "_" + Hashfn::name();
+  }
+};
+}  // namespace learned_hashing
@@ -1,11 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
-#include <memory>
+#include <iterator>
 #include <pgm/pgm_index.hpp>
-#include <pgm/pgm_index_dynamic.hpp>
-#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "convenience/builtins.hpp"
 
@@ -15,9 +15,55 @@ template <typename T, size_t Epsilon, size_t EpsilonRecursive = Epsilon,
           typename Floating = float>
 struct DynamicPGMHash {
  private:
-  using PGM_T = pgm::DynamicPGMIndex<
-      T, std::uint8_t, pgm::PGMIndex<T, Epsilon, EpsilonRecursive, Floating>>;
-  std::unique_ptr<PGM_T> pgm_ptr_;
+  using PGM_T = pgm::PGMIndex<T, Epsilon, EpsilonRecursive, Floating>;
+
+  /// log2 of the capacity of the first (smallest) level
+  static constexpr size_t base_level_bits = 8;
+  /// levels with less capacity are binary searched instead of indexed
+  static constexpr size_t min_indexed_capacity = 1 << 12;
+
+  /**
+   * Sorted, distinct keys, indexed by a PGM once the level's capacity
+   * reaches min_indexed_capacity
+   */
+  struct Level {
+    std::vector<T> keys;
+    PGM_T pgm;
+
+    static constexpr size_t capacity(const size_t level) {
+      return static_cast<size_t>(1) << (base_level_bits + level);
+    }
+
+    /// rebuilds the index after keys changed
+    void index(const size_t level) {
+      pgm = capacity(level) >= min_indexed_capacity && !keys.empty()
+                ? PGM_T(keys.begin(), keys.end())
+                : PGM_T();
+    }
+
+    /// amount of keys in this level smaller than key
+    forceinline size_t lower_bound(const T &key, const size_t level) const {
+      auto lo = keys.begin(), hi = keys.end();
+      if (capacity(level) >= min_indexed_capacity && !keys.empty()) {
+        const auto approx = pgm.search(key);
+        lo = keys.begin() + approx.lo;
+        hi = keys.begin() + approx.hi;
+      }
+      return std::distance(keys.begin(), std::lower_bound(lo, hi, key));
+    }
+
+    forceinline bool contains(const T &key, const size_t level) const {
+      const auto pos = lower_bound(key, level);
+      return pos < keys.size() && keys[pos] == key;
+    }
+  };
+
+  /// LSM-style levels (logarithmic method), i.e., level i holds at most
+  /// Level::capacity(i) keys. Each key is contained in at most one level
+  std::vector<Level> levels;
+
+  /// total amount of (distinct) keys
+  size_t key_count = 0;
 
  public:
   /**
@@ -48,58 +94,251 @@ struct DynamicPGMHash {
    */
   template <class RandomIt>
   void train(const RandomIt &keys_begin, const RandomIt &keys_end) {
-    const auto N = std::distance(keys_begin, keys_end);
+    std::vector<T> keys(keys_begin, keys_end);
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
 
-    std::vector<std::pair<T, std::uint8_t>> data;
-    data.resize(N);
-    for (auto it = keys_begin; it < keys_end; it++) data.emplace_back(*it, 0);
-
-    pgm_ptr_ = std::make_unique<PGM_T>(data.begin(), data.end());
+    // all keys go into the smallest level that is large enough
+    size_t level = 0;
+    while (Level::capacity(level) < keys.size()) level++;
+    levels.clear();
+    levels.resize(level + 1);
+    key_count = keys.size();
+    levels[level].keys = std::move(keys);
+    levels[level].index(level);
   }
 
   /**
    * Amount of models in PGM
    */
-  size_t model_count() const { return pgm_ptr_->segments.size(); }
+  size_t model_count() const {
+    size_t count = 0;
+    for (const auto &level : levels) count += level.pgm.segments.size();
+    return count;
+  }
 
   /**
    * Size of PGM model in bytes
    */
-  size_t byte_size() const { return pgm_ptr_->size_in_bytes(); }
+  size_t byte_size() const {
+    size_t size = sizeof(*this);
+    for (const auto &level : levels)
+      size += sizeof(Level) + level.pgm.size_in_bytes() +
+              level.keys.size() * sizeof(T);
+    return size;
+  }
 
   /**
    * Human readable name useful, e.g., to log measured results
    * @return
    */
   static std::string name() {
-    return "pgm_hash_eps" + std::to_string(Epsilon) + "_epsrec" +
+    return "dynamic_pgm_hash_eps" + std::to_string(Epsilon) + "_epsrec" +
            std::to_string(EpsilonRecursive);
   }
 
   /**
-   * Computes a hash value aiming to be within [0, N] based
-   * on the PGMIndex::search algorithm. Note that additional
-   * reduction might be necessary to guarantee [0, N] bounds.
+   * Computes a hash value within [0, size()], i.e., the rank of key amongst
+   * all trained and inserted keys.
    *
-   * Contrary to PGMIndex::search, the precision available through
-   * segment->slope is not immediately thrown away and instead carried
-   * into the scaling (from input keyset size to [0, N])
-   * computation, which should result in significantly more unique
-   * hash/pos values compared to standard PGMIndex::search() when
-   * the index is only trained on a sample.
+   * Since each key is stored in exactly one level, the rank is the sum of
+   * the per level ranks, each of which is located via the level's PGM (or
+   * binary search for small levels). Hashing therefore takes
+   * O(log(n) * PGM search) instead of walking over all smaller keys.
+   */
+  forceinline size_t operator()(const T &key) const {
+    size_t rank = 0;
+    for (size_t i = 0; i < levels.size(); i++)
+      rank += levels[i].lower_bound(key, i);
+    return rank;
+  }
+
+  /**
+   * Rank of key interpolated between its predecessor and successor amongst
+   * all keys, i.e., the r-th smallest key is at r and other keys fall in
+   * between their neighbours. Keys smaller (larger) than all keys are at -0.5
+   * (size() - 0.5). Contrary to integer ranks, distinct non-keys are mostly
+   * distinguishable.
+   */
+  template <typename Precision = double>
+  forceinline Precision interpolated_rank(const T &key) const {
+    size_t rank = 0;
+    bool has_pred = false, has_succ = false;
+    T pred{}, succ{};
+    for (size_t i = 0; i < levels.size(); i++) {
+      const auto &keys = levels[i].keys;
+      const auto pos = levels[i].lower_bound(key, i);
+      rank += pos;
+      if (pos > 0 && (!has_pred || keys[pos - 1] > pred)) {
+        pred = keys[pos - 1];
+        has_pred = true;
+      }
+      if (pos < keys.size() && (!has_succ || keys[pos] < succ)) {
+        succ = keys[pos];
+        has_succ = true;
+      }
+    }
+
+    if (!has_succ) return static_cast<Precision>(rank) - 0.5;
+    if (!has_pred) return key == succ ? 0 : -0.5;
+    return static_cast<Precision>(rank - 1) +
+           static_cast<Precision>(key - pred) /
+               static_cast<Precision>(succ - pred);
+  }
+
+  /// inserts a new key. Inserting an existing key has no effect
+  void insert(const T &key) {
+    if (contains(key)) return;
+    merge_into_levels(std::vector<T>{key});
+  }
+
+  /**
+   * Inserts all keys in [sorted_begin, sorted_end), which may contain
+   * duplicates and existing keys. Contrary to repeated insert(), the batch
+   * is merged with the smaller levels into the first level with enough
+   * capacity at once, i.e., each level is rebuilt at most once per batch.
    *
-   * @tparam Result
-   * @tparam Precision
-   * @param key
-   * @param N
-   * @return
+   * @param sorted_begin, sorted_end the range containing the sorted (!) keys
    */
-  template <typename Result = size_t, typename Precision = double>
-  forceinline Result operator()(const T &key) const {
-    return std::distance(pgm_ptr_->begin(), pgm_ptr_->lower_bound(key));
+  template <class RandomIt>
+  void insert_batch(const RandomIt &sorted_begin, const RandomIt &sorted_end) {
+    std::vector<T> batch;
+    batch.reserve(std::distance(sorted_begin, sorted_end));
+    for (auto it = sorted_begin; it < sorted_end; it++)
+      if ((batch.empty() || batch.back() != *it) && !contains(*it))
+        batch.push_back(*it);
+    if (!batch.empty()) merge_into_levels(std::move(batch));
+  }
+
+  /// amount of distinct keys, i.e., upper bound of the hash values
+  size_t size() const { return key_count; }
+
+ private:
+  forceinline bool contains(const T &key) const {
+    for (size_t i = 0; i < levels.size(); i++)
+      if (levels[i].contains(key, i)) return true;
+    return false;
+  }
+
+  /// merges sorted, new keys and all levels up to the first one with enough
+  /// capacity into that level
+  void merge_into_levels(std::vector<T> merged) {
+    const size_t added = merged.size();
+    size_t target = 0;
+    size_t merged_size = added;
+    for (;; target++) {
+      if (target == levels.size()) levels.emplace_back();
+      merged_size += levels[target].keys.size();
+      if (merged_size <= Level::capacity(target)) break;
+    }
+
+    merged.reserve(merged_size);
+    std::vector<T> tmp;
+    tmp.reserve(merged_size);
+    for (size_t i = 0; i < target; i++) {
+      auto &level = levels[i].keys;
+      if (level.empty()) continue;
+      tmp.clear();
+      std::merge(merged.begin(), merged.end(), level.begin(), level.end(),
+                 std::back_inserter(tmp));
+      std::swap(merged, tmp);
+      level.clear();
+      levels[i].index(i);
+    }
+    auto &level = levels[target].keys;
+    tmp.clear();
+    std::merge(merged.begin(), merged.end(), level.begin(), level.end(),
+               std::back_inserter(tmp));
+    level = std::move(tmp);
+    levels[target].index(target);
+    key_count += added;
+  }
+};
+
+/**
+ * DynamicPGMHash scaled to a target output range [0, full_size), e.g., the
+ * slot count of a growing hash table.
+ *
+ * Hash values of present keys must not change while the table's size stays
+ * the same. Inserted keys are therefore only buffered and hashed with the
+ * current model, i.e., like any other key not contained in the sample. The
+ * table rehashes anyway when it grows, which is when rescale() merges the
+ * buffered keys into the model via insert_batch(), i.e., without retraining
+ * from scratch, and updates the output range.
+ */
+template <typename T, size_t Epsilon, size_t EpsilonRecursive = Epsilon,
+          typename Floating = float>
+struct ScaledDynamicPGMHash {
+ private:
+  DynamicPGMHash<T, Epsilon, EpsilonRecursive, Floating> model;
+
+  /// inserted keys not yet merged into the model
+  std::vector<T> pending;
+
+  size_t full_size = 0;
+  /// maps interpolated ranks in [-1, model.size()) to [0, full_size)
+  double scale = 0;
+
+ public:
+  ScaledDynamicPGMHash() noexcept = default;
+
+  /**
+   * @param sample_begin, sample_end the range containing the sorted (!) keys
+   * to be indexed
+   * @param full_size the output range of the hash function [0, full_size)
+   */
+  template <typename RandomIt>
+  ScaledDynamicPGMHash(const RandomIt &sample_begin,
+                       const RandomIt &sample_end, const size_t full_size) {
+    train(sample_begin, sample_end, full_size);
+  }
+
+  template <class RandomIt>
+  void train(const RandomIt &sample_begin, const RandomIt &sample_end,
+             const size_t full_size) {
+    model.train(sample_begin, sample_end);
+    pending.clear();
+    rescale(full_size);
+  }
+
+  /// buffers key, i.e., hash values do not change until the next rescale()
+  void insert(const T &key) { pending.push_back(key); }
+
+  /// merges all inserted keys into the model and changes the output range to
+  /// [0, new_full_size). Hash values of all keys may change
+  void rescale(const size_t new_full_size) {
+    if (!pending.empty()) {
+      std::sort(pending.begin(), pending.end());
+      model.insert_batch(pending.begin(), pending.end());
+      pending.clear();
+    }
+    full_size = new_full_size;
+    scale = static_cast<double>(full_size) / (model.size() + 1);
+  }
+
+  /// interpolates between ranks, i.e., keys inserted since the last
+  /// rescale() do not all collide with their successor
+  forceinline size_t operator()(const T &key) const {
+    return std::min(
+        static_cast<size_t>((model.interpolated_rank(key) + 1.0) * scale),
+        std::max<size_t>(full_size, 1) - 1);
+  }
+
+  /// current output range, i.e., [0, output_size())
+  size_t output_size() const { return full_size; }
+
+  /// amount of keys in the model, excluding keys inserted since rescale()
+  size_t size() const { return model.size(); }
+
+  /// amount of keys inserted since the last rescale()
+  size_t pending_count() const { return pending.size(); }
+
+  size_t model_count() const { return model.model_count(); }
+
+  size_t byte_size() const {
+    return sizeof(*this) - sizeof(model) + model.byte_size() +
+           pending.capacity() * sizeof(T);
   }
 
-  /// inserts a new key
-  void insert(const T &key) { pgm_ptr_->insert_or_assign(key, 0); }
+  static std::string name() { return "scaled_" + decltype(model)::name(); }
 };
 }  // namespace learned_hashing
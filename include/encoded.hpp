@@ -0,0 +1,72 @@
+#pragma once
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+#include "convenience/key_traits.hpp"
+
+namespace learned_hashing {
+/**
+ * Adapts a hash function over unsigned integers to keys of type Key, e.g.,
+ * double timestamps, float sensor readings or signed integers. Keys are
+ * encoded via KeyTraits<Key> both at train and lookup time, which preserves
+ * their order (monotone hash functions stay monotone) and does not branch.
+ *
+ * Example: EncodedKeyHash<double, RMIHash<std::uint64_t, 10'000>>
+ *
+ * Note that encoded floats are only piecewise linear in their value (one
+ * piece per exponent) and that negative and positive floats are encoded
+ * roughly 2^(bits - 1) apart. Models with few linear pieces, e.g., an RMI
+ * with a linear root and only 100 second level models, fit such keysets
+ * poorly. Prefer models adapting to skew, e.g., splines or RadixImpl roots.
+ *
+ * @tparam Key key type
+ * @tparam Hashfn hash function over encoded_key_t<Key>
+ */
+template <class Key, class Hashfn>
+class EncodedKeyHash {
+  using Traits = KeyTraits<Key>;
+
+  Hashfn fn;
+
+ public:
+  using Encoded = encoded_key_t<Key>;
+
+  EncodedKeyHash() = default;
+
+  template <class RandomIt>
+  EncodedKeyHash(const RandomIt &sample_begin, const RandomIt &sample_end,
+                 const size_t full_size) {
+    train(sample_begin, sample_end, full_size);
+  }
+
+  /// [sample_begin, sample_end) must be sorted (according to Key's order),
+  /// i.e., must not contain NaNs
+  template <class RandomIt>
+  void train(const RandomIt &sample_begin, const RandomIt &sample_end,
+             const size_t full_size) {
+    std::vector<Encoded> encoded;
+    encoded.reserve(std::distance(sample_begin, sample_end));
+    for (auto it = sample_begin; it < sample_end; it++)
+      encoded.push_back(Traits::encode(*it));
+    fn.train(encoded.begin(), encoded.end(), full_size);
+  }
+
+  forceinline size_t operator()(const Key &key) const {
+    return fn(Traits::encode(key));
+  }
+
+  /// order-preserving unsigned integer representation of key
+  static forceinline Encoded encode(const Key &key) {
+    return Traits::encode(key);
+  }
+
+  size_t model_count() const { return fn.model_count(); }
+
+  size_t byte_size() const { return fn.byte_size(); }
+
+  static std::string name() { return "encoded_" + Hashfn::name(); }
+};
+}  // namespace learned_hashing
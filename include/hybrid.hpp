@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+
+namespace learned_hashing {
+/// murmur3's 64 bit finalizer, i.e., a fast, well mixing classical hash
+inline std::uint64_t murmur_finalizer(std::uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * Wraps a learned hash function and routes keys from poorly modelled regions
+ * of the key space to a classical hash function (murmur finalizer).
+ *
+ * The key space spanned by the sample is split into 2^NumRegionBits equally
+ * wide regions (like a radix table). At train time, each region's sample keys
+ * are hashed with the learned model into a table with one slot per sample key
+ * and their collisions are compared with the amount expected from a classical
+ * hash, i.e., 1/e of the region's keys:
+ *  - trained on the full dataset (sample_size >= full_size), this is exactly
+ *    the collision behaviour at lookup time. Regions are routed unless the
+ *    model is significantly better than a classical hash, e.g., uniform random
+ *    regions, where the model lookup is pure overhead
+ *  - trained on a sample, even perfectly modelled keys look random at sample
+ *    resolution. Regions are only routed if the model is significantly worse
+ *    than a classical hash, i.e., badly wrong (e.g., outlier tails)
+ *
+ * Routed keys skip the model and are hashed into their region's share of the
+ * output range, which is proportional to the region's key count. Load
+ * therefore stays balanced between learned and classical regions.
+ *
+ * @tparam Hashfn learned hash function to wrap
+ * @tparam NumRegionBits log2 of the amount of regions
+ */
+template <class Data, class Hashfn, size_t NumRegionBits = 12>
+class HybridHash {
+  /// set in region entries whose keys are routed to the classical hash
+  static constexpr std::uint64_t routed_flag = 1ULL << 63;
+
+  /// collision counts have to deviate this many standard deviations from
+  /// a classical hash's to be considered significant
+  static constexpr double significance = 3.0;
+
+  Hashfn fn;
+
+  Data min_key = 0;
+  size_t shift = 0;
+
+  /// region r's output range starts at regions[r] & ~routed_flag and ends at
+  /// regions[r + 1] & ~routed_flag. Flags are stored inline such that routing
+  /// and the classical path only touch a single cache line
+  std::vector<std::uint64_t> regions;
+
+  /// fraction of sample keys (regions) that are routed
+  double routed_keys = 0, routed_regions = 0;
+
+ public:
+  HybridHash() = default;
+
+  template <class RandomIt>
+  HybridHash(const RandomIt &sample_begin, const RandomIt &sample_end,
+             const size_t full_size) {
+    train(sample_begin, sample_end, full_size);
+  }
+
+  /// [sample_begin, sample_end) must be sorted
+  template <class RandomIt>
+  void train(const RandomIt &sample_begin, const RandomIt &sample_end,
+             const size_t full_size) {
+    fn.train(sample_begin, sample_end, full_size);
+
+    const size_t sample_size = std::distance(sample_begin, sample_end);
+    constexpr size_t region_cnt = 1ULL << NumRegionBits;
+
+    min_key = *sample_begin;
+    const auto width = std::bit_width(
+        static_cast<std::uint64_t>(*(sample_end - 1) - min_key));
+    shift = width > NumRegionBits ? width - NumRegionBits : 0;
+
+    // learned collisions per region when hashing the sample into a table with
+    // one slot per sample key
+    std::vector<size_t> key_cnt(region_cnt, 0), collisions(region_cnt, 0);
+    std::vector<bool> occupied(sample_size, false);
+    const double to_sample_slot = static_cast<double>(sample_size) /
+                                  static_cast<double>(std::max<size_t>(
+                                      1, full_size));
+    for (auto it = sample_begin; it < sample_end; it++) {
+      const auto r = region(*it);
+      const size_t slot = std::min<size_t>(
+          static_cast<double>(fn(*it)) * to_sample_slot, sample_size - 1);
+      key_cnt[r]++;
+      collisions[r] += occupied[slot];
+      occupied[slot] = true;
+    }
+
+    // a classical hash collides for 1/e of all keys when hashing n keys into
+    // n slots, i.e., each key collides with probability p = 1/e
+    const double p = std::exp(-1.0);
+    const bool exact = sample_size >= full_size;
+    const auto route = [&](const size_t keys, const size_t collisions) {
+      const double expected = p * static_cast<double>(keys);
+      const double margin =
+          significance * std::sqrt(static_cast<double>(keys) * p * (1.0 - p));
+      return keys > 1 && static_cast<double>(collisions) >
+                             (exact ? expected - margin : expected + margin);
+    };
+
+    regions.assign(region_cnt + 1, 0);
+    size_t cumulative = 0, routed_key_cnt = 0, routed_region_cnt = 0;
+    for (size_t r = 0; r < region_cnt; r++) {
+      regions[r] = static_cast<double>(cumulative) /
+                   static_cast<double>(sample_size) *
+                   static_cast<double>(full_size);
+      cumulative += key_cnt[r];
+
+      if (route(key_cnt[r], collisions[r])) {
+        regions[r] |= routed_flag;
+        routed_key_cnt += key_cnt[r];
+        routed_region_cnt++;
+      }
+    }
+    regions[region_cnt] = full_size;
+
+    routed_keys = static_cast<double>(routed_key_cnt) /
+                  static_cast<double>(sample_size);
+    routed_regions = static_cast<double>(routed_region_cnt) /
+                     static_cast<double>(region_cnt);
+  }
+
+  forceinline size_t operator()(const Data &key) const {
+    const auto r = region(key);
+    const auto entry = regions[r];
+    if (likely(!(entry & routed_flag))) return fn(key);
+
+    // fastrange maps the hash into [begin, end) without a division
+    const std::uint64_t begin = entry & ~routed_flag;
+    const std::uint64_t end = regions[r + 1] & ~routed_flag;
+    const auto h = murmur_finalizer(static_cast<std::uint64_t>(key));
+    return begin + static_cast<std::uint64_t>(
+                       (static_cast<unsigned __int128>(h) * (end - begin)) >>
+                       64);
+  }
+
+  /// region the key belongs to
+  forceinline size_t region(const Data &key) const {
+    if (unlikely(key < min_key)) return 0;
+    return std::min<size_t>(
+        static_cast<std::uint64_t>(key - min_key) >> shift,
+        (1ULL << NumRegionBits) - 1);
+  }
+
+  /// whether keys from region r are hashed by the classical hash function
+  bool routed(const size_t region) const {
+    return regions[region] & routed_flag;
+  }
+
+  size_t region_count() const { return 1ULL << NumRegionBits; }
+
+  /// fraction of (sample) keys hashed by the classical hash function
+  double routed_key_fraction() const { return routed_keys; }
+
+  /// fraction of regions hashed by the classical hash function
+  double routed_region_fraction() const { return routed_regions; }
+
+  size_t model_count() const { return fn.model_count(); }
+
+  size_t byte_size() const {
+    return sizeof(*this) - sizeof(fn) + fn.byte_size() +
+           regions.size() * sizeof(std::uint64_t);
+  }
+
+  static std::string name() {
+    return "hybrid_rbits" + std::to_string(NumRegionBits) + "_" +
+           Hashfn::name();
+  }
+};
+}  // namespace learned_hashing
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+#include "convenience/key_traits.hpp"
+#include "convenience/simd.hpp"
+
+namespace learned_hashing {
+/**
+ * Order preserving hash table, i.e., a hash table keyed by a monotone hash
+ * function (MonotoneRMIHash, CHTHash, RadixSplineHash, TrieSplineHash). Since
+ * x < y implies hashfn(x) <= hashfn(y), buckets laid out in hash order hold
+ * ascending key ranges, which allows ordered iteration & range queries in
+ * addition to point lookups.
+ *
+ * Each bucket stores up to one cache line of keys (slot_count) sorted in
+ * place, i.e., probing a bucket is a single SIMD compare (simd::count_less).
+ * Keys that do not fit into their bucket spill to the bucket's overflow list,
+ * which is kept sorted and only holds keys larger than the bucket's slots,
+ * i.e., a bucket's keys are its slots followed by its overflow list.
+ *
+ * Payloads are stored separately from keys, i.e., probing only touches the
+ * bucket's key cache line and a successful lookup one payload cache line.
+ *
+ * @tparam Key unsigned integer keys
+ * @tparam Payload value type
+ * @tparam Hashfn monotone (!) hash function
+ */
+template <class Key, class Payload, class Hashfn>
+class MonotoneHashTable {
+  static_assert(is_unsigned_key<Key>);
+
+ public:
+  /// keys per bucket, i.e., one cache line
+  static constexpr size_t slot_count = 64 / sizeof(Key);
+
+ private:
+  /// key slots of one bucket. Unused slots contain the largest key
+  struct alignas(64) KeySlots {
+    Key keys[slot_count];
+  };
+
+  struct BucketMeta {
+    /// amount of used slots
+    std::uint32_t size = 0;
+    /// index + 1 of the bucket's overflow list, 0 if there is none
+    std::uint32_t overflow = 0;
+  };
+
+  static constexpr Key empty_key = static_cast<Key>(~Key{});
+
+  Hashfn hashfn;
+
+  std::vector<KeySlots> key_slots;
+  std::vector<Payload> payloads;
+  std::vector<BucketMeta> meta;
+  std::vector<std::vector<std::pair<Key, Payload>>> overflows;
+
+  size_t key_count = 0;
+
+ public:
+  /// position of a key in the table, i.e., bucket & index within the bucket
+  /// (slots first, then overflow list). Invalidated by inserts
+  class Iterator {
+    const MonotoneHashTable *table = nullptr;
+    size_t bucket = 0, pos = 0;
+
+    friend class MonotoneHashTable;
+
+    Iterator(const MonotoneHashTable *table, const size_t bucket,
+             const size_t pos)
+        : table(table), bucket(bucket), pos(pos) {
+      skip_exhausted();
+    }
+
+    /// moves to the first key of the next non-empty bucket if pos is past the
+    /// end of bucket
+    forceinline void skip_exhausted() {
+      while (bucket < table->bucket_count() &&
+             pos >= table->bucket_size(bucket)) {
+        bucket++;
+        pos = 0;
+      }
+    }
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<Key, Payload>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const Key &, const Payload &>;
+
+    Iterator() = default;
+
+    forceinline const Key &key() const {
+      const auto &m = table->meta[bucket];
+      if (likely(pos < m.size)) return table->key_slots[bucket].keys[pos];
+      return table->overflows[m.overflow - 1][pos - m.size].first;
+    }
+
+    forceinline const Payload &payload() const {
+      const auto &m = table->meta[bucket];
+      if (likely(pos < m.size))
+        return table->payloads[bucket * slot_count + pos];
+      return table->overflows[m.overflow - 1][pos - m.size].second;
+    }
+
+    forceinline reference operator*() const { return {key(), payload()}; }
+
+    forceinline Iterator &operator++() {
+      pos++;
+      skip_exhausted();
+      return *this;
+    }
+
+    forceinline Iterator operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return bucket == other.bucket && pos == other.pos;
+    }
+  };
+
+  /// keys within [lo, hi) in ascending order, see range()
+  struct Range {
+    Iterator first, last;
+
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
+  };
+
+  MonotoneHashTable() = default;
+
+  /**
+   * @param sample_begin, sample_end sorted (!) sample of the keys to train
+   *   the hash function on
+   * @param capacity amount of key slots, i.e., capacity / slot_count buckets.
+   *   Keys beyond a bucket's slots are stored in its overflow list
+   */
+  template <class RandomIt>
+  MonotoneHashTable(const RandomIt &sample_begin, const RandomIt &sample_end,
+                    const size_t capacity)
+      : key_slots(std::max<size_t>(1, (capacity + slot_count - 1) /
+                                          slot_count)),
+        payloads(key_slots.size() * slot_count),
+        meta(key_slots.size()) {
+    for (auto &slots : key_slots)
+      std::fill(std::begin(slots.keys), std::end(slots.keys), empty_key);
+    if (sample_begin != sample_end)
+      hashfn = Hashfn(sample_begin, sample_end, key_slots.size());
+  }
+
+  /**
+   * Inserts key with payload, unless key is already contained.
+   * @return whether key was inserted
+   */
+  bool insert(const Key &key, const Payload &payload) {
+    const size_t b = bucket(key);
+    auto &m = meta[b];
+    auto &keys = key_slots[b].keys;
+    const size_t pos = simd::count_less<slot_count>(keys, key);
+
+    if (pos < m.size && keys[pos] == key) return false;
+
+    if (pos == slot_count) {
+      // larger than all slots, i.e., belongs into the overflow list
+      if (m.overflow == 0) {
+        overflows.emplace_back();
+        m.overflow = overflows.size();
+      }
+      auto &overflow = overflows[m.overflow - 1];
+      const auto it = std::lower_bound(
+          overflow.begin(), overflow.end(), key,
+          [](const auto &entry, const Key &k) { return entry.first < k; });
+      if (it != overflow.end() && it->first == key) return false;
+      overflow.emplace(it, key, payload);
+      key_count++;
+      return true;
+    }
+
+    // spill largest slot key to the front of the overflow list
+    auto *values = payloads.data() + b * slot_count;
+    if (m.size == slot_count) {
+      if (m.overflow == 0) {
+        overflows.emplace_back();
+        m.overflow = overflows.size();
+      }
+      auto &overflow = overflows[m.overflow - 1];
+      overflow.emplace(overflow.begin(), keys[slot_count - 1],
+                       values[slot_count - 1]);
+      m.size--;
+    }
+
+    std::copy_backward(keys + pos, keys + m.size, keys + m.size + 1);
+    std::copy_backward(values + pos, values + m.size, values + m.size + 1);
+    keys[pos] = key;
+    values[pos] = payload;
+    m.size++;
+    key_count++;
+    return true;
+  }
+
+  /// iterator to key, end() if key is not contained
+  forceinline Iterator find(const Key &key) const {
+    const size_t b = bucket(key);
+    const auto &m = meta[b];
+    const auto &keys = key_slots[b].keys;
+    const size_t pos = simd::count_less<slot_count>(keys, key);
+
+    if (likely(pos < m.size)) {
+      if (keys[pos] == key) return Iterator(this, b, pos);
+      return end();
+    }
+    if (pos < slot_count || m.overflow == 0) return end();
+
+    const auto &overflow = overflows[m.overflow - 1];
+    const auto it = std::lower_bound(
+        overflow.begin(), overflow.end(), key,
+        [](const auto &entry, const Key &k) { return entry.first < k; });
+    if (it == overflow.end() || it->first != key) return end();
+    return Iterator(this, b, m.size + std::distance(overflow.begin(), it));
+  }
+
+  /// payload of key, nullptr if key is not contained
+  forceinline const Payload *lookup(const Key &key) const {
+    const auto it = find(key);
+    return it == end() ? nullptr : &it.payload();
+  }
+
+  forceinline bool contains(const Key &key) const { return find(key) != end(); }
+
+  /// iterator to the smallest key not less than key, end() if there is none
+  forceinline Iterator lower_bound(const Key &key) const {
+    const size_t b = bucket(key);
+    const auto &m = meta[b];
+    const size_t pos = simd::count_less<slot_count>(key_slots[b].keys, key);
+    if (likely(pos < slot_count || m.overflow == 0))
+      return Iterator(this, b, std::min<size_t>(pos, m.size));
+
+    const auto &overflow = overflows[m.overflow - 1];
+    const auto it = std::lower_bound(
+        overflow.begin(), overflow.end(), key,
+        [](const auto &entry, const Key &k) { return entry.first < k; });
+    return Iterator(this, b, m.size + std::distance(overflow.begin(), it));
+  }
+
+  /**
+   * All keys within [lo, hi) in ascending order, e.g.,
+   *   for (const auto &[key, payload] : table.range(lo, hi)) ...
+   */
+  forceinline Range range(const Key &lo, const Key &hi) const {
+    if (!(lo < hi)) return {end(), end()};
+    return {lower_bound(lo), lower_bound(hi)};
+  }
+
+  /**
+   * Calls fn(key, payload) for all keys within [lo, hi) in ascending order.
+   * Contrary to iterating range(lo, hi), this scans bucket by bucket and
+   * stops at the first key not less than hi, i.e., does not locate hi first
+   */
+  template <class Fn>
+  forceinline void range(const Key &lo, const Key &hi, const Fn &fn) const {
+    if (!(lo < hi)) return;
+
+    // keys in buckets past bucket(hi) are larger than hi
+    const size_t last = bucket(hi);
+    size_t b = bucket(lo);
+    size_t pos = simd::count_less<slot_count>(key_slots[b].keys, lo);
+    for (; b <= last; b++, pos = 0) {
+      const auto &m = meta[b];
+      const auto &keys = key_slots[b].keys;
+      const auto *values = payloads.data() + b * slot_count;
+      for (; pos < m.size; pos++) {
+        if (!(keys[pos] < hi)) return;
+        fn(keys[pos], values[pos]);
+      }
+      if (m.overflow == 0) continue;
+
+      const auto &overflow = overflows[m.overflow - 1];
+      auto it = overflow.begin();
+      if (pos == slot_count)
+        it = std::lower_bound(
+            overflow.begin(), overflow.end(), lo,
+            [](const auto &entry, const Key &k) { return entry.first < k; });
+      for (; it != overflow.end(); it++) {
+        if (!(it->first < hi)) return;
+        fn(it->first, it->second);
+      }
+    }
+  }
+
+  Iterator begin() const { return Iterator(this, 0, 0); }
+  Iterator end() const { return Iterator(this, bucket_count(), 0); }
+
+  /// amount of keys
+  size_t size() const { return key_count; }
+
+  size_t bucket_count() const { return key_slots.size(); }
+
+  /// amount of keys in bucket b, including its overflow list
+  size_t bucket_size(const size_t b) const {
+    const auto &m = meta[b];
+    return m.size + (m.overflow == 0 ? 0 : overflows[m.overflow - 1].size());
+  }
+
+  /// amount of keys stored in overflow lists
+  size_t overflow_count() const {
+    size_t count = 0;
+    for (const auto &overflow : overflows) count += overflow.size();
+    return count;
+  }
+
+  size_t byte_size() const {
+    size_t size = sizeof(*this) + hashfn.byte_size() +
+                  key_slots.size() * sizeof(KeySlots) +
+                  payloads.size() * sizeof(Payload) +
+                  meta.size() * sizeof(BucketMeta);
+    for (const auto &overflow : overflows)
+      size += sizeof(overflow) +
+              overflow.capacity() * sizeof(std::pair<Key, Payload>);
+    return size;
+  }
+
+  static std::string name() { return "monotone_table_" + Hashfn::name(); }
+
+ private:
+  forceinline size_t bucket(const Key &key) const {
+    return std::min<size_t>(hashfn(key), key_slots.size() - 1);
+  }
+};
+}  // namespace learned_hashing
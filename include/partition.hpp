@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+#include "convenience/simd.hpp"
+
+namespace learned_hashing {
+/**
+ * Partitions keys into partition_count partitions, i.e., writes keys to out
+ * such that partition p occupies [offsets[p], offsets[p + 1]) of out, where
+ * offsets is the returned vector of partition_count + 1 offsets. Keys with
+ * partition_fn(key) >= partition_count go into the last partition.
+ *
+ * Classic two pass (radix) partitioning: a histogram pass counts keys per
+ * partition and thread, a prefix sum over the histograms yields each thread's
+ * write cursor per partition and a scatter pass writes keys. The scatter
+ * pass buffers keys in one cache line per partition (software write
+ * combining) and writes full lines at once via non-temporal stores, i.e.,
+ * scattered writes neither read output cache lines nor touch a cache line
+ * (and TLB entry) per key.
+ *
+ * The partition function is evaluated twice per key, which is cheaper than
+ * materializing partition ids for most models. Partitioning is stable, i.e.,
+ * keys within a partition retain their order, independent of thread_count.
+ *
+ * @param partition_fn maps keys to partitions \in [0, partition_count)
+ * @param keys keys to partition, e.g., a std::vector or std::span
+ * @param partition_count amount of partitions
+ * @param out receives the partitioned keys, resized to keys.size()
+ * @param thread_count amount of threads. 0 for hardware concurrency
+ * @return partition offsets into out
+ */
+template <class PartitionFn, class Keys,
+          class Key = typename Keys::value_type>
+std::vector<size_t> partition_by(const PartitionFn &partition_fn,
+                                 const Keys &keys,
+                                 const size_t partition_count,
+                                 std::vector<Key> &out,
+                                 size_t thread_count = 0) {
+  if (partition_count == 0)
+    throw std::invalid_argument("partition_count must be positive");
+
+  out.resize(keys.size());
+  if (thread_count == 0)
+    thread_count = std::max(1U, std::thread::hardware_concurrency());
+  thread_count = std::max<size_t>(1, std::min(thread_count, keys.size()));
+
+  // runs fn(thread_id, begin, end) on equally sized chunks of keys
+  const size_t chunk = (keys.size() + thread_count - 1) / thread_count;
+  const auto parallel_for = [&](const auto &fn) {
+    if (thread_count == 1) return fn(0, 0, keys.size());
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; t++)
+      threads.emplace_back(fn, t, std::min(keys.size(), t * chunk),
+                           std::min(keys.size(), (t + 1) * chunk));
+    for (auto &thread : threads) thread.join();
+  };
+  const auto part = [&](const Key &key) {
+    return std::min<size_t>(partition_fn(key), partition_count - 1);
+  };
+
+  // histogram pass
+  std::vector<std::vector<size_t>> cursors(
+      thread_count, std::vector<size_t>(partition_count, 0));
+  parallel_for([&](const size_t t, const size_t begin, const size_t end) {
+    auto &histogram = cursors[t];
+    for (size_t i = begin; i < end; i++) histogram[part(keys[i])]++;
+  });
+
+  // prefix sum, i.e., thread t writes partition p after threads 0..t-1
+  std::vector<size_t> offsets(partition_count + 1, 0);
+  size_t offset = 0;
+  for (size_t p = 0; p < partition_count; p++) {
+    offsets[p] = offset;
+    for (size_t t = 0; t < thread_count; t++) {
+      const auto count = cursors[t][p];
+      cursors[t][p] = offset;
+      offset += count;
+    }
+  }
+  offsets[partition_count] = offset;
+
+  // scatter pass with software write combining: keys are buffered in one
+  // cache line per partition whose slots mirror the alignment of the output
+  // cache line they belong to. Full lines are streamed to out, i.e., written
+  // without reading out's cache lines first
+  if constexpr (64 % sizeof(Key) != 0) {
+    parallel_for([&](const size_t t, const size_t begin, const size_t end) {
+      auto &cursor = cursors[t];
+      for (size_t i = begin; i < end; i++)
+        out[cursor[part(keys[i])]++] = keys[i];
+    });
+  } else {
+    constexpr size_t line_size = 64 / sizeof(Key);
+    struct alignas(64) Line {
+      Key keys[line_size];
+    };
+    const size_t misalignment =
+        (reinterpret_cast<std::uintptr_t>(out.data()) / sizeof(Key)) %
+        line_size;
+    const auto slot = [&](const size_t pos) {
+      return (pos + misalignment) % line_size;
+    };
+
+    parallel_for([&](const size_t t, const size_t begin, const size_t end) {
+      auto &cursor = cursors[t];
+      const std::vector<size_t> start = cursor;
+      std::vector<Line> lines(partition_count);
+
+      for (size_t i = begin; i < end; i++) {
+        const auto p = part(keys[i]);
+        const size_t pos = cursor[p]++;
+        const size_t s = slot(pos);
+        lines[p].keys[s] = keys[i];
+        if (s == line_size - 1) {
+          if (likely(pos + 1 >= start[p] + line_size)) {
+            simd::stream_line(&out[pos + 1 - line_size], lines[p].keys);
+          } else {
+            // first line of this thread's range might be shared
+            const size_t n = pos + 1 - start[p];
+            std::copy(lines[p].keys + line_size - n, lines[p].keys + line_size,
+                      out.begin() + start[p]);
+          }
+        }
+      }
+
+      // partially filled last lines
+      for (size_t p = 0; p < partition_count; p++) {
+        const size_t pending = std::min(slot(cursor[p]), cursor[p] - start[p]);
+        const size_t first = cursor[p] - pending;
+        std::copy(lines[p].keys + slot(first),
+                  lines[p].keys + slot(first) + pending, out.begin() + first);
+      }
+      simd::stream_fence();
+    });
+  }
+
+  return offsets;
+}
+
+/**
+ * Partitions keys using a learned model as partition function, see
+ * partition_by(). Since the model approximates the keys' CDF, partitions
+ * are balanced (as long as the model is accurate at partition granularity)
+ * and ordered, i.e., all keys of partition p are smaller than those of p + 1
+ * for monotone models. This makes learned partitioning a drop-in replacement
+ * for radix partitioning on skewed keys, e.g., to split join inputs across
+ * cores.
+ *
+ * The model is expected to be trained with full_size = keys.size(), e.g.,
+ * the model that also hashes keys into a table, and its hash values are
+ * scaled down to partitions. Training with full_size = partition_count would
+ * work as well but most models' rounding at the borders of their output range
+ * (e.g., [0, full_size - 1)) then unbalances the first and last partition.
+ *
+ * @param hashfn model trained with full_size = keys.size()
+ * @param keys keys to partition
+ * @param partition_count amount of partitions
+ * @param out receives the partitioned keys, resized to keys.size()
+ * @param thread_count amount of threads. 0 for hardware concurrency
+ * @return partition offsets into out
+ */
+template <class Hashfn, class Keys, class Key = typename Keys::value_type>
+std::vector<size_t> learned_partition(const Hashfn &hashfn, const Keys &keys,
+                                      const size_t partition_count,
+                                      std::vector<Key> &out,
+                                      const size_t thread_count = 0) {
+  const double scale = static_cast<double>(partition_count) /
+                       std::max<size_t>(keys.size(), 1);
+  return partition_by(
+      [&](const Key &key) {
+        return static_cast<size_t>(static_cast<double>(hashfn(key)) * scale);
+      },
+      keys, partition_count, out, thread_count);
+}
+}  // namespace learned_hashing
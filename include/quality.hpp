@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+
+namespace learned_hashing {
+namespace quality {
+/**
+ * Collision behaviour of a hash function on a concrete keyset, i.e., the
+ * properties of a hash table with table_size slots (buckets) that contains
+ * all keys
+ */
+struct Report {
+  size_t key_count = 0;
+  size_t table_size = 0;
+
+  /// keys that hash to an already occupied slot, i.e., key_count - occupied
+  size_t collisions = 0;
+
+  /// fraction of slots no key hashes to
+  double empty_slot_fraction = 0;
+
+  /// maximum amount of keys hashing to the same slot
+  size_t max_load = 0;
+
+  /// percentiles of the slot load experienced by keys, i.e., X% of all keys
+  /// hash to a slot with at most load_pX keys
+  size_t load_p50 = 0, load_p90 = 0, load_p99 = 0, load_p999 = 0;
+
+  /// expected amount of probes for a successful lookup in a linear probing
+  /// table. Infinity if key_count > table_size
+  double linear_probing_expected_probes = 0;
+
+  /// Pearson's chi-square statistic of the slot loads versus a uniform
+  /// distribution of keys across slots
+  double chi_square = 0;
+};
+
+/**
+ * Exactly evaluates hashfn's collision behaviour for the given keys and table
+ * size. Hash values >= table_size are clamped to table_size - 1.
+ *
+ * Hashing, counting slot loads and evaluating them (including the linear
+ * probing sweep) are split across thread_count threads.
+ *
+ * @param hashfn trained hash function, i.e., hashfn(key) \in [0, table_size)
+ * @param keys keyset to evaluate (any order)
+ * @param table_size amount of slots
+ * @param thread_count amount of threads. 0 for hardware concurrency
+ */
+template <class Hashfn, class Key>
+Report evaluate(const Hashfn &hashfn, const std::vector<Key> &keys,
+                const size_t table_size, size_t thread_count = 0) {
+  Report report;
+  report.key_count = keys.size();
+  report.table_size = table_size;
+  if (table_size == 0 || keys.empty()) return report;
+
+  if (thread_count == 0)
+    thread_count = std::max(1U, std::thread::hardware_concurrency());
+
+  // runs fn(thread_id, begin, end) on equally sized chunks of [0, n)
+  const auto parallel_for = [&](const size_t n, const auto &fn) {
+    if (thread_count == 1) return fn(0, 0, n);
+
+    std::vector<std::thread> threads;
+    const size_t chunk = (n + thread_count - 1) / thread_count;
+    for (size_t t = 0; t < thread_count; t++)
+      threads.emplace_back(fn, t, std::min(n, t * chunk),
+                           std::min(n, (t + 1) * chunk));
+    for (auto &thread : threads) thread.join();
+  };
+
+  const auto slot_of = [&](const Key &key) {
+    return std::min<size_t>(hashfn(key), table_size - 1);
+  };
+
+  // slot loads. Keys are partitioned by slot range (counting sort), i.e.,
+  // each thread only increments the loads of its own ranges and threads
+  // neither contend on hot slots nor need private copies of all loads
+  std::vector<std::uint32_t> loads(table_size, 0);
+  if (thread_count == 1) {
+    for (const auto &key : keys) loads[slot_of(key)]++;
+  } else {
+    // ranges hold less than 2^32 slots, i.e., offsets within them fit 32 bit
+    const size_t range_count =
+        std::max<size_t>(thread_count, (table_size >> 32) + 1);
+    const size_t range_size = (table_size + range_count - 1) / range_count;
+
+    // amount of keys of each thread per range, then the position of these
+    // keys in the partitioned offsets, i.e., ordered by range then thread
+    std::vector<size_t> counts(thread_count * range_count, 0);
+    parallel_for(keys.size(), [&](const size_t t, const size_t begin,
+                                  const size_t end) {
+      for (size_t i = begin; i < end; i++)
+        counts[t * range_count + slot_of(keys[i]) / range_size]++;
+    });
+    std::vector<size_t> range_begin(range_count + 1, 0);
+    for (size_t r = 0, pos = 0; r < range_count; r++) {
+      range_begin[r] = pos;
+      for (size_t t = 0; t < thread_count; t++) {
+        const size_t count = counts[t * range_count + r];
+        counts[t * range_count + r] = pos;
+        pos += count;
+      }
+    }
+    range_begin[range_count] = keys.size();
+
+    // rehashes instead of storing each key's slot to keep the extra memory
+    // at 32 bit per key
+    std::vector<std::uint32_t> offsets(keys.size());
+    parallel_for(keys.size(), [&](const size_t t, const size_t begin,
+                                  const size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        const size_t slot = slot_of(keys[i]);
+        offsets[counts[t * range_count + slot / range_size]++] =
+            static_cast<std::uint32_t>(slot % range_size);
+      }
+    });
+    parallel_for(range_count, [&](size_t, const size_t begin,
+                                  const size_t end) {
+      for (size_t r = begin; r < end; r++)
+        for (size_t i = range_begin[r]; i < range_begin[r + 1]; i++)
+          loads[r * range_size + offsets[i]]++;
+    });
+  }
+
+  // per thread aggregates over slot loads
+  struct Partial {
+    size_t empty = 0;
+    double chi_square = 0;
+    /// slots_with_load[l] = amount of slots with load l
+    std::vector<size_t> slots_with_load;
+    /// linear probing carry out of the thread's slots given no carry in
+    size_t carry = 0;
+    /// amount of keys minus amount of slots of the thread's slots
+    std::int64_t surplus = 0;
+    /// linear probing displacement within the thread's slots
+    size_t displacement = 0;
+  };
+  std::vector<Partial> partials(thread_count);
+  const double expected_load = static_cast<double>(keys.size()) /
+                               static_cast<double>(table_size);
+  parallel_for(table_size, [&](const size_t t, const size_t begin,
+                               const size_t end) {
+    auto &partial = partials[t];
+    for (size_t i = begin; i < end; i++) {
+      const auto load = loads[i];
+      partial.empty += load == 0;
+      partial.chi_square += (load - expected_load) * (load - expected_load);
+      if (load >= partial.slots_with_load.size())
+        partial.slots_with_load.resize(load + 1, 0);
+      partial.slots_with_load[load]++;
+      partial.carry = partial.carry + load > 0 ? partial.carry + load - 1 : 0;
+      partial.surplus += static_cast<std::int64_t>(load) - 1;
+    }
+  });
+
+  size_t empty = 0;
+  std::vector<size_t> slots_with_load;
+  for (const auto &partial : partials) {
+    empty += partial.empty;
+    report.chi_square += partial.chi_square / expected_load;
+    if (partial.slots_with_load.size() > slots_with_load.size())
+      slots_with_load.resize(partial.slots_with_load.size(), 0);
+    for (size_t l = 0; l < partial.slots_with_load.size(); l++)
+      slots_with_load[l] += partial.slots_with_load[l];
+  }
+
+  report.collisions = keys.size() - (table_size - empty);
+  report.empty_slot_fraction =
+      static_cast<double>(empty) / static_cast<double>(table_size);
+  report.max_load = slots_with_load.size() - 1;
+
+  // load percentiles from the perspective of keys
+  const auto percentile = [&](const double p) {
+    size_t cumulative_keys = 0;
+    for (size_t l = 1; l < slots_with_load.size(); l++) {
+      cumulative_keys += l * slots_with_load[l];
+      if (static_cast<double>(cumulative_keys) >=
+          p * static_cast<double>(keys.size()))
+        return l;
+    }
+    return report.max_load;
+  };
+  report.load_p50 = percentile(0.5);
+  report.load_p90 = percentile(0.9);
+  report.load_p99 = percentile(0.99);
+  report.load_p999 = percentile(0.999);
+
+  // Total displacement in a linear probing table does not depend on insertion
+  // order. Each slot passes on all keys but one that reach it (carry), and
+  // each passed on key costs an additional probe. A sequence of slots passes
+  // on max(carry_in + surplus, carry) keys, where carry is its carry out
+  // given no carry in. Hence the carry wrapping around the table's end is
+  // the table's carry out given no carry in, and each thread's carry in
+  // follows from the preceding threads' partials
+  if (keys.size() > table_size) {
+    report.linear_probing_expected_probes =
+        std::numeric_limits<double>::infinity();
+  } else {
+    const auto carry_out = [](const Partial &partial, const size_t carry_in) {
+      return static_cast<size_t>(std::max<std::int64_t>(
+          static_cast<std::int64_t>(carry_in) + partial.surplus,
+          static_cast<std::int64_t>(partial.carry)));
+    };
+    std::vector<size_t> carry_in(thread_count, 0);
+    for (const auto &partial : partials)
+      carry_in[0] = carry_out(partial, carry_in[0]);
+    for (size_t t = 1; t < thread_count; t++)
+      carry_in[t] = carry_out(partials[t - 1], carry_in[t - 1]);
+
+    parallel_for(table_size, [&](const size_t t, const size_t begin,
+                                 const size_t end) {
+      size_t carry = carry_in[t];
+      for (size_t i = begin; i < end; i++) {
+        carry = carry + loads[i] > 0 ? carry + loads[i] - 1 : 0;
+        partials[t].displacement += carry;
+      }
+    });
+
+    size_t displacement = 0;
+    for (const auto &partial : partials) displacement += partial.displacement;
+    report.linear_probing_expected_probes =
+        1.0 + static_cast<double>(displacement) /
+                  static_cast<double>(keys.size());
+  }
+
+  return report;
+}
+}  // namespace quality
+}  // namespace learned_hashing
@@ -2,16 +2,24 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
 #include <cmath>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "convenience/allocator.hpp"
+#include "convenience/bounds.hpp"
 #include "convenience/builtins.hpp"
+#include "convenience/key_traits.hpp"
+#include "convenience/precision.hpp"
 
 namespace learned_hashing {
 template <class X, class Y>
@@ -27,22 +35,26 @@ struct LinearImpl {
  protected:
   Precision slope = 0, intercept = 0;
 
+  /// Models over keys wider than 64 bits interpolate relative to their
+  /// smallest training key, i.e., f(x) = slope * (x - base) + intercept, since
+  /// converting such keys to Precision directly would drop their low bits.
+  /// Narrower keys keep the plain (and smaller) f(x) = slope * x + intercept
+  static constexpr bool relative = is_wide_key<Key>;
+  struct NoBase {
+    bool operator==(const NoBase &) const = default;
+  };
+  [[no_unique_address]] std::conditional_t<relative, Key, NoBase> base{};
+
  private:
   using Datapoint = DatapointImpl<Key, Precision>;
 
-  static forceinline Precision compute_slope(const Datapoint &min,
-                                             const Datapoint &max) {
-    if (min.x == max.x) return 0;
-
-    // slope = delta(y)/delta(x)
-    return ((max.y - min.y) / (max.x - min.x));
-  }
-
-  static forceinline Precision compute_intercept(const Datapoint &min,
-                                                 const Datapoint &max) {
-    // f(min.x) = min.y <=> slope * min.x + intercept = min.y <=> intercept =
-    // min.y - slope * min.x
-    return (min.y - compute_slope(min, max) * min.x);
+  /// x - base, exact as long as x is close to base
+  forceinline Precision offset(const Key &x) const {
+    if constexpr (relative)
+      return x >= base ? to_precision<Precision>(x - base)
+                       : -to_precision<Precision>(base - x);
+    else
+      return x;
   }
 
   static forceinline Precision compute_slope(const Key &minX,
@@ -67,7 +79,10 @@ struct LinearImpl {
   explicit LinearImpl(const Key &minX, const Precision &minY, const Key &maxX,
                       const Precision &maxY)
       : slope(compute_slope(minX, minY, maxX, maxY)),
-        intercept(compute_intercept(minX, minY, maxX, maxY)) {}
+        intercept(relative ? minY
+                           : compute_intercept(minX, minY, maxX, maxY)) {
+    if constexpr (relative) base = minX;
+  }
 
  public:
   explicit LinearImpl(Precision slope = 0, Precision intercept = 0)
@@ -81,8 +96,8 @@ struct LinearImpl {
    * @param output_range outputs will be in range [0, output_range]
    */
   explicit LinearImpl(const std::vector<Datapoint> &datapoints)
-      : slope(compute_slope(datapoints.front(), datapoints.back())),
-        intercept(compute_intercept(datapoints.front(), datapoints.back())) {
+      : LinearImpl(datapoints.front().x, datapoints.front().y,
+                   datapoints.back().x, datapoints.back().y) {
     assert(slope != NAN);
     assert(intercept != NAN);
   }
@@ -122,7 +137,7 @@ struct LinearImpl {
    * computes y \in [0, 1] given a certain x
    */
   forceinline Precision normalized(const Key &k) const {
-    const auto res = slope * k + intercept;
+    const auto res = slope * offset(k) + intercept;
     if (res > 1.0) return 1.0;
     if (res < 0.0) return 0.0;
     return res;
@@ -135,7 +150,12 @@ struct LinearImpl {
   forceinline Key normalized_inverse(const Precision y) const {
     // y = ax + b <=> x = (y-b)/a
     // +0.5 to round up (TODO(dominik): is this necessary?)
-    return 0.5 + (y - intercept) / slope;
+    if constexpr (relative) {
+      const Precision x = 0.5 + (y - intercept) / slope;
+      return x >= 0 ? base + static_cast<Key>(x) : base - static_cast<Key>(-x);
+    } else {
+      return 0.5 + (y - intercept) / slope;
+    }
   }
 
   /**
@@ -156,20 +176,294 @@ struct LinearImpl {
   }
 
   /**
-   * Two LinearImpl are equal if their slope & intercept match *exactly*
+   * Two LinearImpl are equal if their slope & intercept (& base) match
+   * *exactly*
    */
   bool operator==(const LinearImpl<Key, Precision> other) const {
-    return slope == other.slope && intercept == other.intercept;
+    return slope == other.slope && intercept == other.intercept &&
+           base == other.base;
   }
 
   forceinline Precision get_slope() const { return slope; }
+  /// f(0), or f(base) for keys wider than 64 bits
   forceinline Precision get_intercept() const { return intercept; }
+
+  size_t byte_size() const { return sizeof(*this); }
+
+  static std::string name() { return "linear"; }
+};
+
+/**
+ * Root model that extracts the top NumRadixBits bits of (key - min_key), just
+ * like RadixSpline's radix table, and looks up the cdf value of the first key
+ * within that prefix. Within a prefix, the model interpolates linearly.
+ *
+ * Contrary to LinearImpl, this adapts to skewed data (e.g., normal, osm) since
+ * densely populated key ranges receive proportionally more output space.
+ */
+template <class Key, class Precision, size_t NumRadixBits = 12,
+          class Allocator = std::allocator<Key>>
+struct RadixImpl {
+ private:
+  Key min_key = 0;
+  size_t num_shift_bits = 0;
+
+  /// normalized cdf value of the first key with prefix >= i, i.e.,
+  /// table[prefix] is the smallest and table[prefix + 1] the largest output
+  /// for keys with the given prefix
+  std::vector<Precision, rebind_alloc_t<Allocator, Precision>> table;
+
+  static size_t compute_num_shift_bits(const Key &diff) {
+    const size_t significant_bits = key_bit_width(static_cast<Key>(diff));
+    if (significant_bits < NumRadixBits) return 0;
+    return significant_bits - NumRadixBits;
+  }
+
+ public:
+  RadixImpl() = default;
+
+  /**
+   * Builds the radix table on the given, *sorted* keys.
+   *
+   * @param keys sorted key array
+   * @param begin first key contained in the training bucket
+   * @param end last key contained in the training bucket
+   */
+  template <class It>
+  RadixImpl(const It &dataset_begin, const It &dataset_end, size_t begin,
+            size_t end)
+      : min_key(*(dataset_begin + begin)),
+        num_shift_bits(compute_num_shift_bits(*(dataset_begin + end) -
+                                              *(dataset_begin + begin))) {
+    const auto N =
+        static_cast<Precision>(std::distance(dataset_begin, dataset_end));
+    const size_t max_prefix =
+        (*(dataset_begin + end) - min_key) >> num_shift_bits;
+    table.resize(max_prefix + 2, 0);
+
+    size_t prev_prefix = 0;
+    for (size_t i = begin; i <= end; i++) {
+      const size_t prefix = (*(dataset_begin + i) - min_key) >> num_shift_bits;
+      for (size_t p = prev_prefix + 1; p <= prefix; p++)
+        table[p] = static_cast<Precision>(i) / N;
+      prev_prefix = std::max(prev_prefix, prefix);
+    }
+    for (size_t p = prev_prefix + 1; p < table.size(); p++)
+      table[p] = static_cast<Precision>(end) / N;
+  }
+
+  /**
+   * computes y \in [0, 1] given a certain x
+   */
+  forceinline Precision normalized(const Key &k) const {
+    if (k <= min_key) return table.front();
+
+    const Key rel = k - min_key;
+    const size_t prefix = rel >> num_shift_bits;
+    if (unlikely(prefix + 1 >= table.size())) return table.back();
+
+    const Precision lower = table[prefix];
+    const Precision upper = table[prefix + 1];
+    const Precision frac =
+        to_precision<Precision>(rel -
+                                (static_cast<Key>(prefix) << num_shift_bits)) /
+        to_precision<Precision>(static_cast<Key>(1) << num_shift_bits);
+    return lower + (upper - lower) * frac;
+  }
+
+  /**
+   * Extrapolates an index for the given key to the range [0, max_value]
+   *
+   * @param k key value to extrapolate for
+   * @param max_value output indices are \in [0, max_value]
+   */
+  forceinline size_t
+  operator()(const Key &k, const Precision &max_value =
+                               std::numeric_limits<Precision>::max()) const {
+    // +0.5 as a quick&dirty ceil trick
+    const size_t pred = max_value * normalized(k) + 0.5;
+    assert(pred <= max_value);
+    return pred;
+  }
+
+  bool operator==(const RadixImpl &other) const {
+    return min_key == other.min_key &&
+           num_shift_bits == other.num_shift_bits && table == other.table;
+  }
+
+  size_t byte_size() const {
+    return sizeof(*this) + table.size() * sizeof(Precision);
+  }
+
+  static std::string name() { return "radix" + std::to_string(NumRadixBits); }
+};
+
+/**
+ * Root model that interpolates between NumKnots + 1 equidistant (in rank
+ * space) knots of the training data's cdf. Knot keys and cdf values are kept
+ * in separate arrays, i.e., the search only touches the (small) key array.
+ */
+template <class Key, class Precision, size_t NumKnots = 64,
+          class Allocator = std::allocator<Key>>
+struct LinearSplineImpl {
+ private:
+  std::vector<Key, rebind_alloc_t<Allocator, Key>> knot_x;
+  std::vector<Precision, rebind_alloc_t<Allocator, Precision>> knot_y;
+
+ public:
+  LinearSplineImpl() = default;
+
+  /**
+   * Places knots at equidistant ranks of the *sorted* keys.
+   *
+   * @param keys sorted key array
+   * @param begin first key contained in the training bucket
+   * @param end last key contained in the training bucket
+   */
+  template <class It>
+  LinearSplineImpl(const It &dataset_begin, const It &dataset_end,
+                   size_t begin, size_t end) {
+    const auto N =
+        static_cast<Precision>(std::distance(dataset_begin, dataset_end));
+    knot_x.reserve(NumKnots + 1);
+    knot_y.reserve(NumKnots + 1);
+
+    for (size_t j = 0; j <= NumKnots; j++) {
+      const size_t i = begin + (end - begin) * j / NumKnots;
+      const Key x = *(dataset_begin + i);
+
+      // spline must be strictly monotone in x to allow interpolation
+      if (!knot_x.empty() && knot_x.back() == x) continue;
+
+      knot_x.push_back(x);
+      knot_y.push_back(static_cast<Precision>(i) / N);
+    }
+  }
+
+  /**
+   * computes y \in [0, 1] given a certain x
+   */
+  forceinline Precision normalized(const Key &k) const {
+    if (k <= knot_x.front()) return knot_y.front();
+    if (k >= knot_x.back()) return knot_y.back();
+
+    // knot_x[i-1] < k <= knot_x[i]
+    const size_t i = std::distance(
+        knot_x.begin(), std::lower_bound(knot_x.begin(), knot_x.end(), k));
+    assert(i > 0 && i < knot_x.size());
+
+    const Precision x_diff = to_precision<Precision>(knot_x[i] - knot_x[i - 1]);
+    const Precision y_diff = knot_y[i] - knot_y[i - 1];
+    const Precision key_diff = to_precision<Precision>(k - knot_x[i - 1]);
+    return knot_y[i - 1] + key_diff * (y_diff / x_diff);
+  }
+
+  /**
+   * Extrapolates an index for the given key to the range [0, max_value]
+   *
+   * @param k key value to extrapolate for
+   * @param max_value output indices are \in [0, max_value]
+   */
+  forceinline size_t
+  operator()(const Key &k, const Precision &max_value =
+                               std::numeric_limits<Precision>::max()) const {
+    // +0.5 as a quick&dirty ceil trick
+    const size_t pred = max_value * normalized(k) + 0.5;
+    assert(pred <= max_value);
+    return pred;
+  }
+
+  bool operator==(const LinearSplineImpl &other) const {
+    return knot_x == other.knot_x && knot_y == other.knot_y;
+  }
+
+  size_t byte_size() const {
+    return sizeof(*this) + knot_x.size() * sizeof(Key) +
+           knot_y.size() * sizeof(Precision);
+  }
+
+  static std::string name() { return "spline" + std::to_string(NumKnots); }
+};
+
+/// min/max signed error, i.e., true position - hash value, of the keys a
+/// second level model is responsible for
+struct ModelError {
+  std::int64_t min = std::numeric_limits<std::int64_t>::max();
+  std::int64_t max = std::numeric_limits<std::int64_t>::min();
 };
 
+/**
+ * Measures the error of each of model_count (second level) models on the
+ * sorted keys in [begin, end), including the non-keys in between: a non-key
+ * x \in (keys[i - 1], keys[i]] has the same lower bound position as keys[i].
+ * Since the root model and each second level model are monotone, x is
+ * assigned to a model m \in [index(keys[i - 1]), index(keys[i])] and hashed
+ * within [hash(m, keys[i - 1]), hash(m, keys[i])], which bounds its error.
+ *
+ * @param begin, end sorted keys
+ * @param model_count amount of models, i.e., index() \in [0, model_count)
+ * @param index maps keys to models
+ * @param hash hash(m, key) computes the hash value of key using model m
+ * @param position true position of the i-th key, i \in [0, end - begin]
+ * @param thread_count amount of threads. 0 for hardware concurrency
+ */
+template <class RandomIt, class IndexFn, class HashFn, class PositionFn>
+std::vector<ModelError> measure_model_errors(
+    const RandomIt &begin, const RandomIt &end, const size_t model_count,
+    const IndexFn &index, const HashFn &hash, const PositionFn &position,
+    size_t thread_count = 0) {
+  using Key = typename std::iterator_traits<RandomIt>::value_type;
+  static_assert(is_unsigned_key<Key>);
+
+  const size_t n = std::distance(begin, end);
+  if (thread_count == 0)
+    thread_count = std::max(1U, std::thread::hardware_concurrency());
+  thread_count = std::max<size_t>(1, std::min(thread_count, n / 4096));
+
+  // intervals [keys[i - 1], keys[i]] for i \in [from, to), where keys[-1] and
+  // keys[n] are the smallest and largest representable key
+  const auto measure = [&](std::vector<ModelError> &errors, const size_t from,
+                           const size_t to) {
+    errors.assign(model_count, {});
+    for (size_t i = from; i < to; i++) {
+      if (i > 0 && i < n && begin[i] == begin[i - 1]) continue;
+      const Key lo = i > 0 ? begin[i - 1] : Key{};
+      const Key hi = i < n ? begin[i] : static_cast<Key>(~Key{});
+      const auto pos = static_cast<std::int64_t>(position(i));
+      for (size_t m = index(lo), last = index(hi); m <= last; m++) {
+        auto &error = errors[m];
+        error.min =
+            std::min(error.min, pos - static_cast<std::int64_t>(hash(m, hi)));
+        error.max =
+            std::max(error.max, pos - static_cast<std::int64_t>(hash(m, lo)));
+      }
+    }
+  };
+
+  std::vector<std::vector<ModelError>> errors(thread_count);
+  const size_t chunk = (n + 1 + thread_count - 1) / thread_count;
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < thread_count; t++)
+    threads.emplace_back(measure, std::ref(errors[t]),
+                         std::min(n + 1, t * chunk),
+                         std::min(n + 1, (t + 1) * chunk));
+  measure(errors[0], 0, std::min(n + 1, chunk));
+  for (auto &thread : threads) thread.join();
+
+  for (size_t t = 1; t < thread_count; t++)
+    for (size_t m = 0; m < model_count; m++) {
+      errors[0][m].min = std::min(errors[0][m].min, errors[t][m].min);
+      errors[0][m].max = std::max(errors[0][m].max, errors[t][m].max);
+    }
+  return std::move(errors[0]);
+}
+
 template <class Key, size_t MaxSecondLevelModelCount,
-          size_t MinAvgDatapointsPerModel = 2, class Precision = double,
+          size_t MinAvgDatapointsPerModel = 2,
+          class Precision = default_precision_t<Key>,
           class RootModel = LinearImpl<Key, Precision>,
-          class SecondLevelModel = LinearImpl<Key, Precision>>
+          class SecondLevelModel = LinearImpl<Key, Precision>,
+          class Allocator = std::allocator<Key>>
 class RMIHash {
   using Datapoint = DatapointImpl<Key, Precision>;
 
@@ -177,11 +471,16 @@ class RMIHash {
   RootModel root_model;
 
   /// Second level models
-  std::vector<SecondLevelModel> second_level_models;
+  std::vector<SecondLevelModel, rebind_alloc_t<Allocator, SecondLevelModel>>
+      second_level_models;
 
   /// output range is scaled from [0, 1] to [0, max_output] = [0, full_size)
   size_t max_output = 0;
 
+  /// error bounds per second level model (or the root model if there are
+  /// none). Empty unless measured, see measure_errors()
+  std::vector<ModelError, rebind_alloc_t<Allocator, ModelError>> model_errors;
+
  public:
   /**
    * Constructs an empty, untrained RMI. to train, manually
@@ -219,6 +518,67 @@ class RMIHash {
   template <class RandomIt>
   void train(const RandomIt &sample_begin, const RandomIt &sample_end,
              const size_t full_size, bool faster_construction = true) {
+    model_errors.clear();
+    train_models(sample_begin, sample_end, full_size, faster_construction);
+  }
+
+  /**
+   * Measures the exact error bounds of each model on all keys, e.g., after
+   * training on a sample, such that bounds() holds for any key. Opt-in, i.e.,
+   * only RMIs used for search pay for a full pass over the data and the
+   * additional sizeof(ModelError) bytes per model. Measures in parallel on
+   * thread_count threads (0 for hardware concurrency)
+   *
+   * @param data_begin, data_end all (full_size many) keys, sorted (!)
+   */
+  template <class RandomIt>
+  void measure_errors(const RandomIt &data_begin, const RandomIt &data_end,
+                      const size_t thread_count = 0) {
+    model_errors.clear();
+    if (data_begin == data_end ||
+        (MaxSecondLevelModelCount > 0 && second_level_models.empty()))
+      return;
+
+    const auto errors = measure_model_errors(
+        data_begin, data_end, std::max<size_t>(1, second_level_models.size()),
+        [&](const Key &key) { return second_level_index(key); },
+        [&](const size_t m, const Key &key) { return model_hash(m, key); },
+        [](const size_t i) { return i; }, thread_count);
+    model_errors.assign(errors.begin(), errors.end());
+  }
+
+  /**
+   * Search bound of key within the data errors were measured on (see
+   * measure_errors()), i.e., the position of the first key not less than key
+   * is within [begin, end) or end == full_size if there is no such key.
+   *
+   * Bounds are exact (for keys and non-keys) after measure_errors() and span
+   * [0, full_size] otherwise
+   */
+  forceinline Bounds bounds(const Key &key) const {
+    const auto full_size = static_cast<std::int64_t>(max_output) + 1;
+    if (unlikely(model_errors.empty()))
+      return {0, static_cast<size_t>(full_size)};
+
+    const size_t m = second_level_index(key);
+    const auto hash = static_cast<std::int64_t>(model_hash(m, key));
+    const auto &error = model_errors[m];
+    return {static_cast<size_t>(
+                std::clamp<std::int64_t>(hash + error.min, 0, full_size)),
+            static_cast<size_t>(
+                std::clamp<std::int64_t>(hash + error.max + 1, 0, full_size))};
+  }
+
+  /// error bounds of the second level model responsible for key
+  forceinline ModelError error(const Key &key) const {
+    if (unlikely(model_errors.empty())) return {};
+    return model_errors[second_level_index(key)];
+  }
+
+ private:
+  template <class RandomIt>
+  void train_models(const RandomIt &sample_begin, const RandomIt &sample_end,
+                    const size_t full_size, bool faster_construction) {
     this->max_output = full_size - 1;
     const size_t sample_size = std::distance(sample_begin, sample_end);
     if (sample_size == 0) return;
@@ -323,17 +683,41 @@ class RMIHash {
     }
   }
 
+  /// hash value of key computed by second level model m
+  forceinline size_t model_hash(const size_t m, const Key &key) const {
+    if (MaxSecondLevelModelCount == 0) return root_model(key, max_output);
+    return second_level_models[m](key, max_output);
+  }
+
+ public:
   static std::string name() {
-    return "rmi_hash_" + std::to_string(MaxSecondLevelModelCount);
+    // only non-default root models are named to keep names of existing
+    // results (benchmarks, stats) stable
+    if constexpr (std::is_same_v<RootModel, LinearImpl<Key, Precision>>)
+      return "rmi_hash_" + std::to_string(MaxSecondLevelModelCount) +
+             allocator_name<Allocator>();
+    return "rmi_hash_" + RootModel::name() + "_" +
+           std::to_string(MaxSecondLevelModelCount) +
+           allocator_name<Allocator>();
   }
 
   size_t byte_size() const {
-    return sizeof(decltype(this)) +
-           sizeof(SecondLevelModel) * second_level_models.size();
+    return sizeof(decltype(this)) + root_model.byte_size() +
+           sizeof(SecondLevelModel) * second_level_models.size() +
+           sizeof(ModelError) * model_errors.size();
   }
 
   size_t model_count() const { return 1 + second_level_models.size(); }
 
+  /**
+   * Index of the second level model responsible for key as predicted by the
+   * root model. Useful to judge how evenly the root model distributes keys
+   */
+  forceinline size_t second_level_index(const Key &key) const {
+    if (MaxSecondLevelModelCount == 0) return 0;
+    return root_model(key, second_level_models.size() - 1);
+  }
+
   /**
    * Compute hash value for key
    *
@@ -372,9 +756,11 @@ class RMIHash {
  * using LinearImpl models
  */
 template <class Key, size_t MaxSecondLevelModelCount,
-          size_t MinAvgDatapointsPerModel = 2, class Precision = double,
+          size_t MinAvgDatapointsPerModel = 2,
+          class Precision = default_precision_t<Key>,
           class RootModel = LinearImpl<Key, Precision>,
-          class SecondLevelModel = LinearImpl<Key, Precision>>
+          class SecondLevelModel = LinearImpl<Key, Precision>,
+          class Allocator = std::allocator<Key>>
 class MonotoneRMIHash {
   using Datapoint = DatapointImpl<Key, Precision>;
   using Model = LinearImpl<Key, Precision>;
@@ -383,11 +769,17 @@ class MonotoneRMIHash {
   RootModel root_model;
 
   /// Second level models
-  std::vector<SecondLevelModel> second_level_models;
+  std::vector<SecondLevelModel, rebind_alloc_t<Allocator, SecondLevelModel>>
+      second_level_models;
 
   /// output range is scaled from [0, 1] to [0, max_output] = [0, full_size)
   size_t full_size = 0;
 
+  /// error bounds per second level model (or the root model if there are
+  /// none) plus one for keys beyond the last model. Empty unless measured,
+  /// see measure_errors()
+  std::vector<ModelError, rebind_alloc_t<Allocator, ModelError>> model_errors;
+
  public:
   /**
    * Constructs an empty, untrained RMI. to train, manually
@@ -419,6 +811,52 @@ class MonotoneRMIHash {
   template <class RandomIt>
   void train(const RandomIt &sample_begin, const RandomIt &sample_end,
              const size_t full_size) {
+    model_errors.clear();
+    train_models(sample_begin, sample_end, full_size);
+  }
+
+  /// see RMIHash::measure_errors()
+  template <class RandomIt>
+  void measure_errors(const RandomIt &data_begin, const RandomIt &data_end,
+                      const size_t thread_count = 0) {
+    model_errors.clear();
+    if (data_begin == data_end ||
+        (MaxSecondLevelModelCount > 0 && second_level_models.empty()))
+      return;
+
+    const auto errors = measure_model_errors(
+        data_begin, data_end,
+        MaxSecondLevelModelCount == 0 ? 1 : second_level_models.size() + 1,
+        [&](const Key &key) { return second_level_index(key); },
+        [&](const size_t m, const Key &key) { return model_hash(m, key); },
+        [](const size_t i) { return i; }, thread_count);
+    model_errors.assign(errors.begin(), errors.end());
+  }
+
+  /// see RMIHash::bounds()
+  forceinline Bounds bounds(const Key &key) const {
+    const auto size = static_cast<std::int64_t>(full_size);
+    if (unlikely(model_errors.empty())) return {0, full_size};
+
+    const size_t m = second_level_index(key);
+    const auto hash = static_cast<std::int64_t>(model_hash(m, key));
+    const auto &error = model_errors[m];
+    return {static_cast<size_t>(
+                std::clamp<std::int64_t>(hash + error.min, 0, size)),
+            static_cast<size_t>(
+                std::clamp<std::int64_t>(hash + error.max + 1, 0, size))};
+  }
+
+  /// error bounds of the second level model responsible for key
+  forceinline ModelError error(const Key &key) const {
+    if (unlikely(model_errors.empty())) return {};
+    return model_errors[second_level_index(key)];
+  }
+
+ private:
+  template <class RandomIt>
+  void train_models(const RandomIt &sample_begin, const RandomIt &sample_end,
+                    const size_t full_size) {
     this->full_size = full_size;
     const size_t sample_size = std::distance(sample_begin, sample_end);
     if (sample_size == 0) return;
@@ -447,7 +885,7 @@ class MonotoneRMIHash {
           static_cast<double>(i) /
           static_cast<double>(second_level_models.size()));
     };
-    const auto true_min_y = [&](const size_t i, const size_t i_min_x) {
+    const auto true_min_y = [&](const size_t i, const Key &i_min_x) {
       if (i == 0) return 0.0;
       const auto prev_max_y = second_level_models[i - 1].normalized(i_min_x);
       return prev_max_y;
@@ -488,15 +926,39 @@ class MonotoneRMIHash {
     train_until(second_level_models.size());
   }
 
+  /// hash value of key computed by second level model m
+  forceinline size_t model_hash(const size_t m, const Key &key) const {
+    if (MaxSecondLevelModelCount == 0) return root_model(key, full_size);
+    if (m >= second_level_models.size()) return full_size - 1;
+
+    const size_t res = second_level_models[m].normalized(key) * full_size;
+    return res - ((res >= full_size) & 0x1);
+  }
+
+ public:
   static std::string name() {
-    return "monotone_rmi_hash_" + std::to_string(MaxSecondLevelModelCount);
+    return "monotone_rmi_hash_" + std::to_string(MaxSecondLevelModelCount) +
+           allocator_name<Allocator>();
   }
 
   size_t byte_size() const {
-    return sizeof(decltype(this)) + sizeof(Model) * second_level_models.size();
+    return sizeof(decltype(this)) + sizeof(Model) * second_level_models.size() +
+           sizeof(ModelError) * model_errors.size();
   }
 
-  size_t model_count() { return 1 + second_level_models.size(); }
+  size_t model_count() const { return 1 + second_level_models.size(); }
+
+  /**
+   * Index of the second level model responsible for key as predicted by the
+   * root model, see RMIHash::second_level_index(). second_level_models.size()
+   * for keys beyond the last model
+   */
+  forceinline size_t second_level_index(const Key &key) const {
+    if (MaxSecondLevelModelCount == 0) return 0;
+    return std::min<size_t>(
+        root_model.normalized(key) * second_level_models.size(),
+        second_level_models.size());
+  }
 
   /**
    * Compute hash value for key
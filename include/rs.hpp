@@ -1,9 +1,11 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "convenience/allocator.hpp"
 #include "convenience/builtins.hpp"
 #include "rs/builder.h"
 #include "rs/radix_spline.h"
@@ -11,13 +13,15 @@
 namespace learned_hashing {
 template <class Data, const size_t NumRadixBits = 18,
           const size_t MaxError = 32,
-          const size_t MaxModels = std::numeric_limits<size_t>::max()>
+          const size_t MaxModels = std::numeric_limits<size_t>::max(),
+          const _rs::SplineLayout Layout = _rs::SplineLayout::Sorted,
+          class Allocator = std::allocator<Data>>
 class RadixSplineHash {
   /// output range is scaled from [0, 1] to [0, full_size) via this factor
   double out_scale_fac;
 
   /// internal model, a radix spline
-  _rs::RadixSpline<Data> spline;
+  _rs::RadixSpline<Data, Layout, Allocator> spline;
 
 public:
   RadixSplineHash() = default;
@@ -44,13 +48,13 @@ public:
       rsb.AddKey(*it);
 
     // actually build radix spline
-    spline = rsb.Finalize();
+    spline = rsb.template Finalize<Layout, Allocator>();
 
     // check that we're within accepted bounds of MaxModels
-    if (spline.spline_points_.size() > MaxModels)
+    if (spline.SplinePointsCount() > MaxModels)
       throw std::runtime_error("RS " + name() +
                                " had more models than allowed: " +
-                               std::to_string(spline.spline_points_.size()) +
+                               std::to_string(spline.SplinePointsCount()) +
                                " > " + std::to_string(MaxModels));
   }
 
@@ -58,7 +62,7 @@ public:
     return spline.GetEstimatedPosition(key) * out_scale_fac;
   }
 
-  size_t model_count() const { return spline.spline_points_.size(); }
+  size_t model_count() const { return spline.SplinePointsCount(); }
 
   size_t byte_size() const {
     return sizeof(decltype(out_scale_fac)) + spline.GetSize();
@@ -66,7 +70,11 @@ public:
 
   static std::string name() {
     return "radix_spline_err" + std::to_string(MaxError) + "_rbits" +
-           std::to_string(NumRadixBits);
+           std::to_string(NumRadixBits) +
+           (Layout == _rs::SplineLayout::BTree         ? "_btree"
+            : Layout == _rs::SplineLayout::Interleaved ? "_interleaved"
+                                                       : "") +
+           allocator_name<Allocator>();
   }
 };
 } // namespace learned_hashing
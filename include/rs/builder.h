@@ -3,7 +3,9 @@
 #include <cassert>
 #include <cmath>
 #include <limits>
+#include <memory>
 
+#include "../convenience/precision.hpp"
 #include "common.h"
 #include "radix_spline.h"
 
@@ -42,7 +44,9 @@ class Builder {
   }
 
   // Finalizes the construction and returns a read-only `RadixSpline`.
-  RadixSpline<KeyType> Finalize() {
+  template <SplineLayout Layout = SplineLayout::Sorted,
+            class Allocator = std::allocator<KeyType>>
+  RadixSpline<KeyType, Layout, Allocator> Finalize() {
     // Last key needs to be equal to `max_key_`.
     assert(curr_num_keys_ == 0 || prev_key_ == max_key_);
 
@@ -53,7 +57,7 @@ class Builder {
     // Maybe even size the radix based on max key right from the start
     FinalizeRadixTable();
 
-    return RadixSpline<KeyType>(
+    return RadixSpline<KeyType, Layout, Allocator>(
         min_key_, max_key_, curr_num_keys_, num_radix_bits_, num_shift_bits_,
         max_error_, std::move(radix_table_), std::move(spline_points_));
   }
@@ -72,6 +76,12 @@ class Builder {
     if ((64 - clzl) < num_radix_bits) return 0;
     return 64 - num_radix_bits - clzl;
   }
+  // KeyType == unsigned __int128.
+  static size_t GetNumShiftBits(unsigned __int128 diff, size_t num_radix_bits) {
+    const size_t bits = key_bit_width(diff);
+    if (bits < num_radix_bits) return 0;
+    return bits - num_radix_bits;
+  }
 
   void AddKey(KeyType key, size_t position) {
     assert(key >= min_key_ && key <= max_key_);
@@ -13,6 +13,18 @@ struct Coord {
   double y;
 };
 
+// Memory layout of the spline points.
+enum class SplineLayout {
+  // Sorted array of x coordinates, binary searched via `std::lower_bound`,
+  // y coordinates in a separate array.
+  Sorted,
+  // Array of `Coord`s, i.e., the original RadixSpline layout, binary searched
+  // via `std::lower_bound`. Kept as baseline for the other layouts.
+  Interleaved,
+  // x coordinates in a `StaticBTree`, y coordinates in a separate array.
+  BTree
+};
+
 struct SearchBound {
   size_t begin;
   size_t end;  // Exclusive.
@@ -3,21 +3,32 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
+#include "../convenience/allocator.hpp"
+#include "../convenience/precision.hpp"
 #include "common.h"
+#include "static_btree.h"
 
 namespace learned_hashing {
 template <class Data, const size_t NumRadixBits, const size_t MaxError,
-          const size_t MaxModels>
+          const size_t MaxModels, const _rs::SplineLayout Layout,
+          class Allocator>
 class RadixSplineHash;
 
 namespace _rs {
 
 // Approximates a cumulative distribution function (CDF) using spline
 // interpolation.
-template <class KeyType>
+template <class KeyType, SplineLayout Layout = SplineLayout::Sorted,
+          class Allocator = std::allocator<KeyType>>
 class RadixSpline {
+  template <class T>
+  using Vector = std::vector<T, rebind_alloc_t<Allocator, T>>;
+
  public:
   RadixSpline() = default;
 
@@ -31,8 +42,28 @@ class RadixSpline {
         num_radix_bits_(num_radix_bits),
         num_shift_bits_(num_shift_bits),
         max_error_(max_error),
-        radix_table_(std::move(radix_table)),
-        spline_points_(std::move(spline_points)) {}
+        radix_table_(rebind_vector<Allocator>(std::move(radix_table))) {
+    if constexpr (Layout == SplineLayout::Interleaved) {
+      spline_points_ = rebind_vector<Allocator>(std::move(spline_points));
+    } else {
+      Vector<KeyType> spline_x;
+      spline_x.reserve(spline_points.size() + simd::scan_padding<KeyType>);
+      spline_y_.reserve(spline_points.size());
+      for (const auto& point : spline_points) {
+        spline_x.push_back(point.x);
+        spline_y_.push_back(point.y);
+      }
+
+      if constexpr (Layout == SplineLayout::BTree) {
+        spline_x_ = StaticBTree<KeyType, Allocator>(spline_x);
+      } else {
+        // Sentinels allow for scanning past the last spline point.
+        spline_x.resize(spline_points.size() + simd::scan_padding<KeyType>,
+                        std::numeric_limits<KeyType>::max());
+        spline_x_ = std::move(spline_x);
+      }
+    }
+  }
 
   // Returns the estimated position of `key`.
   double GetEstimatedPosition(const KeyType key) const {
@@ -42,16 +73,16 @@ class RadixSpline {
 
     // Find spline segment with `key` ∈ (spline[index - 1], spline[index]].
     const size_t index = GetSplineSegment(key);
-    const Coord<KeyType> down = spline_points_[index - 1];
-    const Coord<KeyType> up = spline_points_[index];
+    const Coord<KeyType> down = GetSplinePoint(index - 1);
+    const Coord<KeyType> up = GetSplinePoint(index);
 
     // Compute slope.
-    const double x_diff = up.x - down.x;
+    const double x_diff = to_precision<double>(up.x - down.x);
     const double y_diff = up.y - down.y;
     const double slope = y_diff / x_diff;
 
     // Interpolate.
-    const double key_diff = key - down.x;
+    const double key_diff = to_precision<double>(key - down.x);
     return std::fma(key_diff, slope, down.y);
   }
 
@@ -68,8 +99,19 @@ class RadixSpline {
 
   // Returns the size in bytes.
   size_t GetSize() const {
-    return sizeof(*this) + radix_table_.size() * sizeof(uint32_t) +
-           spline_points_.size() * sizeof(Coord<KeyType>);
+    if constexpr (Layout == SplineLayout::Interleaved)
+      return sizeof(*this) + radix_table_.size() * sizeof(uint32_t) +
+             spline_points_.size() * sizeof(Coord<KeyType>);
+    else
+      return sizeof(*this) + radix_table_.size() * sizeof(uint32_t) +
+             GetSplineXSize() + spline_y_.size() * sizeof(double);
+  }
+
+  size_t SplinePointsCount() const {
+    if constexpr (Layout == SplineLayout::Interleaved)
+      return spline_points_.size();
+    else
+      return spline_y_.size();
   }
 
  protected:
@@ -83,20 +125,38 @@ class RadixSpline {
     const uint32_t begin = radix_table_[prefix];
     const uint32_t end = radix_table_[prefix + 1];
 
-    if (end - begin < 32) {
-      // Do linear search over narrowed range.
-      uint32_t current = begin;
-      while (spline_points_[current].x < key) ++current;
-      return current;
+    if constexpr (Layout == SplineLayout::Interleaved) {
+      if (end - begin < 32) {
+        // Do linear search over narrowed range.
+        uint32_t current = begin;
+        while (spline_points_[current].x < key) ++current;
+        return current;
+      }
+
+      // Do binary search over narrowed range.
+      const auto lb = std::lower_bound(
+          spline_points_.begin() + begin, spline_points_.begin() + end, key,
+          [](const Coord<KeyType>& coord, const KeyType key) {
+            return coord.x < key;
+          });
+      return std::distance(spline_points_.begin(), lb);
+    } else {
+      if (end - begin < 32) {
+        // Do (SIMD) linear search over narrowed range.
+        return begin + simd::scan_lower_bound(spline_x_.data() + begin, key);
+      }
+
+      if constexpr (Layout == SplineLayout::BTree) {
+        // Do B+-tree search within the narrowed range, which is cheaper than
+        // the binary search due to fewer cache misses and branches.
+        return spline_x_.LowerBound(key, begin, end);
+      } else {
+        // Do binary search over narrowed range.
+        const auto lb = std::lower_bound(spline_x_.begin() + begin,
+                                         spline_x_.begin() + end, key);
+        return std::distance(spline_x_.begin(), lb);
+      }
     }
-
-    // Do binary search over narrowed range.
-    const auto lb = std::lower_bound(
-        spline_points_.begin() + begin, spline_points_.begin() + end, key,
-        [](const Coord<KeyType>& coord, const KeyType key) {
-          return coord.x < key;
-        });
-    return std::distance(spline_points_.begin(), lb);
   }
 
   KeyType min_key_;
@@ -106,13 +166,46 @@ class RadixSpline {
   size_t num_shift_bits_;
   size_t max_error_;
 
-  std::vector<uint32_t> radix_table_;
-  std::vector<Coord<KeyType>> spline_points_;
+  Coord<KeyType> GetSplinePoint(const size_t index) const {
+    if constexpr (Layout == SplineLayout::Interleaved)
+      return spline_points_[index];
+    else
+      return {spline_x_[index], spline_y_[index]};
+  }
+
+  size_t GetSplineXSize() const {
+    if constexpr (Layout == SplineLayout::BTree)
+      return spline_x_.GetSize();
+    else
+      return spline_x_.size() * sizeof(KeyType);
+  }
+
+  Vector<uint32_t> radix_table_;
+
+  // Members of layouts other than `Layout`.
+  struct Unused {};
+
+  // SplineLayout::Interleaved
+  [[no_unique_address]] std::conditional_t<
+      Layout == SplineLayout::Interleaved, Vector<Coord<KeyType>>, Unused>
+      spline_points_;
+
+  // SplineLayout::Sorted and SplineLayout::BTree: spline points' x coordinates
+  // (padded with sentinels) and y coordinates in separate arrays, i.e.,
+  // searches only touch the x coordinates.
+  [[no_unique_address]] std::conditional_t<
+      Layout == SplineLayout::BTree, StaticBTree<KeyType, Allocator>,
+      std::conditional_t<Layout == SplineLayout::Sorted, Vector<KeyType>,
+                         Unused>>
+      spline_x_;
+  [[no_unique_address]] std::conditional_t<
+      Layout == SplineLayout::Interleaved, Unused, Vector<double>>
+      spline_y_;
 
   template <typename>
   friend class Serializer;
 
-  template <class, size_t, size_t, size_t>
+  template <class, size_t, size_t, size_t, SplineLayout, class>
   friend class learned_hashing::RadixSplineHash;
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <sstream>
 
 #include "radix_spline.h"
@@ -34,13 +35,13 @@ class Serializer {
     }
 
     // Spline points.
-    const size_t spline_points_size = rs.spline_points_.size();
+    const size_t spline_points_size = rs.SplinePointsCount();
     buffer.write(reinterpret_cast<const char*>(&spline_points_size),
                  sizeof(size_t));
-    for (size_t i = 0; i < rs.spline_points_.size(); ++i) {
-      buffer.write(reinterpret_cast<const char*>(&rs.spline_points_[i].x),
+    for (size_t i = 0; i < spline_points_size; ++i) {
+      buffer.write(reinterpret_cast<const char*>(&rs.spline_x_[i]),
                    sizeof(KeyType));
-      buffer.write(reinterpret_cast<const char*>(&rs.spline_points_[i].y),
+      buffer.write(reinterpret_cast<const char*>(&rs.spline_y_[i]),
                    sizeof(double));
     }
 
@@ -71,11 +72,13 @@ class Serializer {
     // Spline points.
     size_t spline_points_size;
     in.read(reinterpret_cast<char*>(&spline_points_size), sizeof(size_t));
-    rs.spline_points_.resize(spline_points_size);
-    for (int i = 0; i < rs.spline_points_.size(); ++i) {
-      in.read(reinterpret_cast<char*>(&rs.spline_points_[i].x),
-              sizeof(KeyType));
-      in.read(reinterpret_cast<char*>(&rs.spline_points_[i].y), sizeof(double));
+    // Sentinels allow for scanning past the last spline point.
+    rs.spline_x_.resize(spline_points_size + simd::scan_padding<KeyType>,
+                        std::numeric_limits<KeyType>::max());
+    rs.spline_y_.resize(spline_points_size);
+    for (size_t i = 0; i < spline_points_size; ++i) {
+      in.read(reinterpret_cast<char*>(&rs.spline_x_[i]), sizeof(KeyType));
+      in.read(reinterpret_cast<char*>(&rs.spline_y_[i]), sizeof(double));
     }
 
     return rs;
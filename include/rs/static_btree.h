@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../convenience/allocator.hpp"
+#include "../convenience/simd.hpp"
+
+namespace learned_hashing {
+namespace _rs {
+
+// Implicit, read-only B+-tree over sorted keys. Each node spans exactly one
+// cache line and holds the maximum key of each of its children. Searching
+// therefore touches one cache line per level and compares all keys of a node
+// at once using SIMD instead of branching on every key like a binary search.
+template <class KeyType, class Allocator = std::allocator<KeyType>>
+class StaticBTree {
+  using Level = std::vector<KeyType, rebind_alloc_t<Allocator, KeyType>>;
+
+ public:
+  // Keys per node, i.e., fanout.
+  static constexpr size_t kNodeSize = 64 / sizeof(KeyType);
+  static constexpr size_t kNodeBits = std::countr_zero(kNodeSize);
+  static_assert(std::has_single_bit(kNodeSize));
+
+  StaticBTree() = default;
+
+  template <class KeyAllocator>
+  explicit StaticBTree(const std::vector<KeyType, KeyAllocator>& keys)
+      : num_keys_(keys.size()) {
+    // Sentinels allow for scanning (`simd::scan_lower_bound`) past the last
+    // key.
+    Level level(keys.begin(), keys.end());
+    level.resize(num_keys_ + simd::scan_padding<KeyType>,
+                 std::numeric_limits<KeyType>::max());
+    levels_.push_back(std::move(level));
+    Pad(levels_.back());
+
+    // Build levels bottom up until a single node remains.
+    while (levels_.back().size() > kNodeSize) {
+      const auto& child = levels_.back();
+      Level level;
+      level.reserve(child.size() / kNodeSize + kNodeSize);
+      for (size_t i = kNodeSize - 1; i < child.size(); i += kNodeSize)
+        level.push_back(child[i]);
+      Pad(level);
+      levels_.push_back(std::move(level));
+    }
+  }
+
+  // Returns the index of the first key >= `key`, or `size()` if there is no
+  // such key.
+  size_t LowerBound(const KeyType key) const {
+    if (num_keys_ == 0 || key > levels_[0][num_keys_ - 1]) return num_keys_;
+
+    size_t pos = 0;
+    for (size_t level = levels_.size(); level-- > 0;) {
+      const KeyType* node = levels_[level].data() + pos * kNodeSize;
+      pos = pos * kNodeSize + simd::count_less<kNodeSize>(node, key);
+    }
+    assert(pos < num_keys_);
+    return pos;
+  }
+
+  // Returns the index of the first key >= `key`, which must be within
+  // [`begin`, `end`], e.g., a range narrowed by a radix table. Descends from
+  // the lowest node spanning that range instead of from the root, i.e.,
+  // touches one cache line per level below that node only.
+  size_t LowerBound(const KeyType key, const size_t begin,
+                    const size_t end) const {
+    assert(begin <= end && end <= num_keys_);
+
+    // Lowest level whose node containing `begin` also contains `end`. Nodes
+    // on level l span kNodeSize^(l + 1) keys.
+    const size_t span_bits = std::bit_width(begin ^ end);
+    const size_t level = std::min(
+        levels_.size() - 1,
+        std::max<size_t>(1, (span_bits + kNodeBits - 1) / kNodeBits) - 1);
+
+    size_t pos = begin >> ((level + 1) * kNodeBits);
+    for (size_t l = level + 1; l-- > 0;) {
+      const KeyType* node = levels_[l].data() + pos * kNodeSize;
+      pos = pos * kNodeSize + simd::count_less<kNodeSize>(node, key);
+    }
+    assert(begin <= pos && pos <= end);
+    return pos;
+  }
+
+  KeyType operator[](const size_t i) const { return levels_[0][i]; }
+
+  // Sorted keys, padded with sentinels.
+  const KeyType* data() const { return levels_[0].data(); }
+
+  size_t size() const { return num_keys_; }
+
+  // Returns the size in bytes.
+  size_t GetSize() const {
+    size_t size = sizeof(*this);
+    for (const auto& level : levels_) size += level.size() * sizeof(KeyType);
+    return size;
+  }
+
+ private:
+  // Pads `level` with sentinels to fill its last node.
+  static void Pad(Level& level) {
+    const size_t padded_size =
+        std::max(kNodeSize, (level.size() + kNodeSize - 1) / kNodeSize *
+                                kNodeSize);
+    level.resize(padded_size, std::numeric_limits<KeyType>::max());
+  }
+
+  size_t num_keys_ = 0;
+
+  // `levels_[0]` contains all keys, `levels_.back()` is the root node.
+  std::vector<Level> levels_;
+};
+
+}  // namespace _rs
+}  // namespace learned_hashing
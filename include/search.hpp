@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "convenience/bounds.hpp"
+#include "convenience/builtins.hpp"
+
+namespace learned_hashing {
+/**
+ * Branchless binary search, i.e., returns the first position in [begin, end)
+ * whose key is not less than key. Contrary to std::lower_bound, the loop
+ * compiles to conditional moves, i.e., does not suffer branch mispredictions
+ * on small (model bounded) ranges.
+ */
+template <class Key>
+forceinline const Key *branchless_lower_bound(const Key *begin,
+                                              const Key *end,
+                                              const Key &key) {
+  size_t n = end - begin;
+  if (n == 0) return begin;
+  while (n > 1) {
+    const size_t half = n / 2;
+    begin = begin[half] < key ? begin + half : begin;
+    n -= half;
+  }
+  return begin + (*begin < key);
+}
+
+/**
+ * Exponential (galloping) search for key around pos, i.e., returns the first
+ * position in [begin, end) whose key is not less than key in
+ * O(log(|result - pos|)) steps.
+ */
+template <class Key>
+forceinline const Key *exponential_lower_bound(const Key *begin,
+                                               const Key *end, size_t pos,
+                                               const Key &key) {
+  const size_t n = end - begin;
+  if (n == 0) return begin;
+  pos = std::min(pos, n - 1);
+
+  size_t lo, hi;
+  if (begin[pos] < key) {
+    // result in (pos, n]
+    size_t step = 1;
+    lo = pos + 1;
+    while (lo + step <= n && begin[lo + step - 1] < key) {
+      lo += step;
+      step *= 2;
+    }
+    hi = std::min(lo + step, n);
+  } else {
+    // result in [0, pos]
+    size_t step = 1;
+    hi = pos;
+    while (hi >= step && !(begin[hi - step] < key)) {
+      hi -= step;
+      step *= 2;
+    }
+    lo = hi >= step ? hi - step + 1 : 0;
+  }
+  return branchless_lower_bound(begin + lo, begin + hi, key);
+}
+
+/**
+ * Turns a learned hash function into a learned index, i.e., locates keys in
+ * the sorted data the model approximates the CDF of: the hash value is the
+ * estimated position of key in the data, which is corrected by a search over
+ * the positions the model's error permits.
+ *
+ * Models trained on a sample, e.g., as hash functions, have no error bound
+ * wrt. the full data (CHTHash::bounds() and the splines' search bounds only
+ * hold for the sample). Instead, measure_error() records the min/max signed
+ * error of the data's keys per region of 2^ErrorBucketBits estimated
+ * positions. Sampling error changes slowly across the key space, i.e., the
+ * error within a region is far smaller than the global error. Regions also
+ * cover the error of any non-key between two data keys for monotone models
+ * (RadixSplineHash, TrieSplineHash, CHTHash). Lookups of other models
+ * (RMIHash, PGMHash) may fall outside the bounds, which is detected and
+ * handled via exponential search from the estimate, as are lookups before
+ * measure_error() was called.
+ *
+ * Hash values are unchanged, i.e., one model serves as hash function and
+ * index at the same time.
+ *
+ * @tparam Hashfn learned hash function trained with full_size = data size
+ * @tparam ErrorBucketBits log2 of the amount of estimated positions per error
+ *   region
+ */
+template <class Hashfn, size_t ErrorBucketBits = 8>
+class SearchableHash {
+  Hashfn fn;
+
+  /// signed error, i.e., true position - estimated position, per region
+  struct Error {
+    std::int64_t min, max;
+  };
+  std::vector<Error> errors;
+
+  /// size of the data the error was measured on. 0 if not measured
+  size_t data_size = 0;
+
+ public:
+  SearchableHash() = default;
+
+  template <class RandomIt>
+  SearchableHash(const RandomIt &sample_begin, const RandomIt &sample_end,
+                 const size_t full_size) {
+    train(sample_begin, sample_end, full_size);
+  }
+
+  template <class RandomIt>
+  void train(const RandomIt &sample_begin, const RandomIt &sample_end,
+             const size_t full_size) {
+    fn.train(sample_begin, sample_end, full_size);
+    errors.clear();
+    data_size = 0;
+  }
+
+  /**
+   * Records the signed error of the model over sorted_data, i.e., the data
+   * the model was trained for (full_size == sorted_data.size()). Duplicates
+   * are located at their first occurrence.
+   */
+  template <class Keys>
+  void measure_error(const Keys &sorted_data) {
+    const size_t n = sorted_data.size();
+    data_size = n;
+    errors.assign(((std::max<size_t>(n, 1) - 1) >> ErrorBucketBits) + 1,
+                  {std::numeric_limits<std::int64_t>::max(),
+                   std::numeric_limits<std::int64_t>::min()});
+
+    // non-keys between the previous (distinct) key and the key at position i
+    // have lower bound i and are estimated within [prev_est, est] (monotone
+    // models), i.e., their error is within [i - est, i - prev_est]
+    const auto record = [&](const size_t i, const size_t prev_est,
+                            const size_t est) {
+      const auto pos = static_cast<std::int64_t>(i);
+      const auto lo = pos - static_cast<std::int64_t>(est);
+      const auto hi = pos - static_cast<std::int64_t>(std::min(prev_est, est));
+      const size_t first = std::min(prev_est, est) >> ErrorBucketBits;
+      const size_t last = std::max(prev_est, est) >> ErrorBucketBits;
+      for (size_t b = first; b <= last; b++) {
+        errors[b].min = std::min(errors[b].min, lo);
+        errors[b].max = std::max(errors[b].max, hi);
+      }
+    };
+
+    size_t prev_est = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (i > 0 && sorted_data[i] == sorted_data[i - 1]) continue;
+      const size_t est = estimate(sorted_data[i], n);
+      record(i, prev_est, est);
+      prev_est = est;
+    }
+    // keys larger than all keys
+    record(n, prev_est, std::max<size_t>(n, 1) - 1);
+  }
+
+  template <class Key>
+  forceinline size_t operator()(const Key &key) const {
+    return fn(key);
+  }
+
+  /**
+   * Search range of lower_bound(), i.e., the first key not less than key is
+   * within [begin, end] for monotone models (end if all keys in [begin, end)
+   * are less than key). Empty if the error was not measured
+   */
+  template <class Key>
+  forceinline Bounds bounds(const Key &key) const {
+    if (unlikely(errors.empty())) return {0, 0};
+    const size_t est = estimate(key, data_size);
+    const auto &error = errors[est >> ErrorBucketBits];
+    const auto size = static_cast<std::int64_t>(data_size);
+    const auto e = static_cast<std::int64_t>(est);
+    return {static_cast<size_t>(std::clamp<std::int64_t>(e + error.min, 0,
+                                                          size)),
+            static_cast<size_t>(std::clamp<std::int64_t>(e + error.max, 0,
+                                                          size))};
+  }
+
+  /**
+   * Position of the first key in sorted_data not less than key, i.e.,
+   * equivalent to std::lower_bound. sorted_data must be the data the error
+   * was measured on (or, lacking measured error, the model was trained for)
+   *
+   * @param sorted_data contiguous sorted keys, e.g., a std::vector
+   */
+  template <class Keys, class Key = typename Keys::value_type>
+  forceinline size_t lower_bound(const Keys &sorted_data,
+                                 const std::type_identity_t<Key> &key) const {
+    const auto *data = sorted_data.data();
+    const size_t n = sorted_data.size();
+
+    if (likely(n == data_size && !errors.empty())) {
+      const auto bound = bounds(key);
+      const size_t pos =
+          branchless_lower_bound(data + bound.begin, data + bound.end, key) -
+          data;
+
+      // results within the range are correct. Results at its borders are
+      // correct iff the key before (after) the range is smaller (not smaller)
+      if (likely((pos > bound.begin || pos == 0 ||
+                  data[bound.begin - 1] < key) &&
+                 (pos < bound.end || pos == n || !(data[pos] < key))))
+        return pos;
+    }
+    return exponential_lower_bound(data, data + n, estimate(key, n), key) -
+           data;
+  }
+
+  /// min/max signed error (true - estimated position) measured on the data
+  std::int64_t min_measured_error() const {
+    std::int64_t min = 0;
+    for (const auto &error : errors) min = std::min(min, error.min);
+    return min;
+  }
+  std::int64_t max_measured_error() const {
+    std::int64_t max = 0;
+    for (const auto &error : errors) max = std::max(max, error.max);
+    return max;
+  }
+
+  size_t model_count() const { return fn.model_count(); }
+
+  size_t byte_size() const {
+    return fn.byte_size() + sizeof(*this) - sizeof(fn) +
+           errors.size() * sizeof(Error);
+  }
+
+  static std::string name() {
+    return "searchable" + std::to_string(ErrorBucketBits) + "_" +
+           Hashfn::name();
+  }
+
+ private:
+  /// hash value clamped to [0, n), i.e., an estimated position in the data
+  template <class Key>
+  forceinline size_t estimate(const Key &key, const size_t n) const {
+    return std::min<size_t>(fn(key), std::max<size_t>(n, 1) - 1);
+  }
+};
+}  // namespace learned_hashing
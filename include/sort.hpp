@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+#include "partition.hpp"
+#include "rs.hpp"
+
+namespace learned_hashing {
+/// sorts [begin, end) via insertion sort, i.e., in linear time if the range
+/// is (almost) sorted
+template <class RandomIt>
+void insertion_sort(const RandomIt &begin, const RandomIt &end) {
+  if (begin == end) return;
+  for (auto it = begin + 1; it < end; it++) {
+    if (likely(!(*it < *(it - 1)))) continue;
+    auto key = std::move(*it);
+    auto hole = it;
+    do {
+      *hole = std::move(*(hole - 1));
+      hole--;
+    } while (hole > begin && key < *(hole - 1));
+    *hole = std::move(key);
+  }
+}
+
+/**
+ * Sorts [begin, end) using a learned CDF model (LearnedSort):
+ *  1. trains Hashfn on a 1% sample with full_size = end - begin, i.e., the
+ *     model predicts each key's position in the sorted output
+ *  2. partitions keys into ordered buckets by predicted position (see
+ *     learned_partition) into a temporary buffer
+ *  3. places each bucket's keys at their predicted positions via a counting
+ *     sort (the bucket fits into cache) and writes them back to [begin, end)
+ *  4. fixes remaining local inversions via insertion sort, i.e., orders keys
+ *     with equal predicted positions
+ *
+ * For monotone models (e.g., RadixSplineHash, TrieSplineHash), keys are
+ * sorted after step 3 except for keys with equal predicted positions.
+ * Non-monotone models (e.g., RMIHash) are supported, but may leave keys out
+ * of order across model borders, which the final insertion sort has to move
+ * a long way.
+ *
+ * Buckets are sorted in parallel on thread_count threads.
+ *
+ * @tparam Hashfn model over the keys, trained with full_size = end - begin
+ * @param begin, end contiguous range of (unsigned integer) keys
+ * @param thread_count amount of threads. 0 for hardware concurrency
+ */
+template <class Hashfn, class RandomIt>
+void learned_sort(const RandomIt &begin, const RandomIt &end,
+                  size_t thread_count = 0) {
+  using Key = typename std::iterator_traits<RandomIt>::value_type;
+
+  // below this size, model training does not pay off
+  constexpr size_t min_size = 1 << 12;
+  // amount of keys per bucket of the partitioning pass, i.e., buckets fit
+  // into L2 cache during the counting sort
+  constexpr size_t bucket_size = 1 << 14;
+
+  const size_t n = std::distance(begin, end);
+  if (n < min_size) return std::sort(begin, end);
+  if (thread_count == 0)
+    thread_count = std::max(1U, std::thread::hardware_concurrency());
+
+  // 1. train on an evenly spaced 1% sample
+  std::vector<Key> sample;
+  const size_t step = 100;
+  sample.reserve(n / step + 1);
+  for (size_t i = 0; i < n; i += step) sample.push_back(begin[i]);
+  std::sort(sample.begin(), sample.end());
+  const Hashfn hashfn(sample.begin(), sample.end(), n);
+  const auto position = [&](const Key &key) {
+    return std::min<size_t>(hashfn(key), n - 1);
+  };
+
+  // 2. partition into buckets of (predicted) positions
+  const size_t bucket_count = (n + bucket_size - 1) / bucket_size;
+  std::vector<Key> buffer;
+  const auto offsets = partition_by(
+      [&](const Key &key) { return position(key) / bucket_size; },
+      std::span<const Key>(&*begin, n), bucket_count, buffer, thread_count);
+
+  // 3. counting sort by predicted position within each bucket. Buckets are
+  // claimed dynamically since they are only approximately balanced
+  std::atomic<size_t> next_bucket{0};
+  const auto sort_buckets = [&]() {
+    std::vector<std::uint32_t> counts;
+    for (size_t b; (b = next_bucket.fetch_add(1)) < bucket_count;) {
+      const size_t lo = offsets[b], hi = offsets[b + 1];
+      if (lo == hi) continue;
+
+      // predicted positions of bucket b are in [b * bucket_size, ...)
+      const size_t base = b * bucket_size;
+      const size_t width = std::min(bucket_size, n - base);
+      const auto slot = [&](const Key &key) {
+        return std::min(position(key) - base, width - 1);
+      };
+
+      counts.assign(width + 1, 0);
+      for (size_t i = lo; i < hi; i++) counts[slot(buffer[i]) + 1]++;
+      for (size_t s = 1; s <= width; s++) counts[s] += counts[s - 1];
+      for (size_t i = lo; i < hi; i++)
+        begin[lo + counts[slot(buffer[i])]++] = buffer[i];
+
+      // 4. local fixup
+      insertion_sort(begin + lo, begin + hi);
+    }
+  };
+
+  thread_count = std::min(thread_count, bucket_count);
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < thread_count; t++) threads.emplace_back(sort_buckets);
+  sort_buckets();
+  for (auto &thread : threads) thread.join();
+
+  // inversions across buckets (non-monotone models only)
+  insertion_sort(begin, end);
+}
+
+/// learned_sort with RadixSplineHash, i.e., a monotone model
+template <class RandomIt>
+void learned_sort(const RandomIt &begin, const RandomIt &end,
+                  const size_t thread_count = 0) {
+  using Key = typename std::iterator_traits<RandomIt>::value_type;
+  learned_sort<RadixSplineHash<Key, 18, 16>>(begin, end, thread_count);
+}
+}  // namespace learned_hashing
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+
+namespace learned_hashing {
+/**
+ * Adapts an integer learned hash function to (variable length) string keys.
+ *
+ * Strings are mapped to order-preserving 64 bit prefixes: a common prefix
+ * (either learned as the sample's longest common prefix or fixed via Skip)
+ * is skipped and the following characters are packed into an integer, i.e.,
+ * comparing prefixes numerically compares the strings lexicographically.
+ * Hashfn is trained on the sample's prefixes, including duplicates, such that
+ * it learns how many keys share each prefix.
+ *
+ * Characters are packed densely: each byte is replaced by its rank in the
+ * sample's alphabet and prefixes are built in base alphabet size + 1 (0
+ * denotes the end of the string). Packing raw bytes instead would leave most
+ * of the key space empty for small alphabets, e.g., decimal digits only use 10
+ * of 256 values per byte. The resulting step-like CDF is poorly approximated
+ * by (piecewise) linear models, and dense packing fits more characters into a
+ * prefix. Bytes not contained in the sample share the rank of the next
+ * smaller known byte (or of the smallest known byte if there is none), which
+ * preserves order.
+ *
+ * Strings that do not fit into the prefix may tie with other strings, e.g.,
+ * urls of the same host. Prefixes shared by multiple sample keys are recorded
+ * at train time. The remaining suffix of strings with such a prefix is hashed
+ * classically into the output range between the prefix and the next distinct
+ * sample prefix, i.e., [Hashfn(prefix), Hashfn(next prefix)).
+ *
+ * Order is only preserved across strings with distinct prefixes that share
+ * the skipped common prefix.
+ *
+ * @tparam Hashfn hash function over std::uint64_t keys
+ * @tparam Skip amount of leading bytes to skip, learned_skip to learn them
+ */
+template <class Hashfn, size_t Skip = std::numeric_limits<size_t>::max()>
+class StringLearnedHash {
+  Hashfn fn;
+
+  /// amount of leading bytes shared by all (sample) keys
+  size_t skip = 0;
+
+  /// dense, order-preserving code of each byte. 0 denotes the end of string
+  std::array<std::uint16_t, 256> codes{};
+  /// base of packed prefixes, i.e., the amount of distinct codes
+  std::uint64_t base = 257;
+  /// amount of characters packed into a prefix
+  size_t width = 7;
+
+  /// sorted prefixes shared by multiple sample keys and the end of their
+  /// output range, i.e., Hashfn(next distinct prefix)
+  std::vector<std::uint64_t> tie_prefixes;
+  std::vector<size_t> tie_ends;
+
+ public:
+  static constexpr size_t learned_skip = std::numeric_limits<size_t>::max();
+
+  StringLearnedHash() = default;
+
+  template <class RandomIt>
+  StringLearnedHash(const RandomIt &sample_begin, const RandomIt &sample_end,
+                    const size_t full_size) {
+    train(sample_begin, sample_end, full_size);
+  }
+
+  /// [sample_begin, sample_end) must be sorted
+  template <class RandomIt>
+  void train(const RandomIt &sample_begin, const RandomIt &sample_end,
+             const size_t full_size) {
+    // the longest common prefix of a sorted range is the one of its first
+    // and last element
+    if constexpr (Skip == learned_skip) {
+      const std::string_view first = *sample_begin;
+      const std::string_view last = *(sample_end - 1);
+      skip = std::distance(
+          first.begin(),
+          std::mismatch(first.begin(), first.end(), last.begin(), last.end())
+              .first);
+    } else {
+      skip = Skip;
+    }
+
+    // alphabet of the sample, past the skipped prefix
+    std::array<bool, 256> seen{};
+    for (auto it = sample_begin; it < sample_end; it++) {
+      const std::string_view key = *it;
+      for (size_t i = skip; i < key.size(); i++)
+        seen[static_cast<unsigned char>(key[i])] = true;
+    }
+    // bytes below the smallest known byte share its code, i.e., 0 stays
+    // reserved for the end of string
+    std::uint16_t code = 0;
+    for (size_t b = 0; b < seen.size(); b++) {
+      code += seen[b];
+      codes[b] = std::max<std::uint16_t>(code, 1);
+    }
+    // keys without bytes past the skipped prefix (e.g., a single or only
+    // identical sample keys) still need one code besides end of string
+    base = std::max<std::uint64_t>(code, 1) + 1;
+
+    // largest width with base^width <= 2^64
+    width = 0;
+    for (unsigned __int128 range = base;
+         range <= (static_cast<unsigned __int128>(1) << 64); range *= base)
+      width++;
+
+    std::vector<std::uint64_t> prefixes;
+    prefixes.reserve(std::distance(sample_begin, sample_end));
+    for (auto it = sample_begin; it < sample_end; it++)
+      prefixes.push_back(prefix(*it));
+    fn.train(prefixes.begin(), prefixes.end(), full_size);
+
+    tie_prefixes.clear();
+    tie_ends.clear();
+    for (size_t i = 0; i + 1 < prefixes.size();) {
+      size_t j = i + 1;
+      while (j < prefixes.size() && prefixes[j] == prefixes[i]) j++;
+      if (j - i > 1) {
+        tie_prefixes.push_back(prefixes[i]);
+        tie_ends.push_back(j < prefixes.size()
+                               ? std::min<size_t>(fn(prefixes[j]), full_size)
+                               : full_size);
+      }
+      i = j;
+    }
+  }
+
+  forceinline size_t operator()(const std::string_view &key) const {
+    const auto p = prefix(key);
+    const size_t begin = fn(p);
+    if (likely(key.size() <= skip + width)) return begin;
+
+    // potential prefix tie -> classically hash suffix into the prefix's range
+    const auto it =
+        std::lower_bound(tie_prefixes.begin(), tie_prefixes.end(), p);
+    if (likely(it == tie_prefixes.end() || *it != p)) return begin;
+    const size_t end = tie_ends[std::distance(tie_prefixes.begin(), it)];
+    if (end <= begin + 1) return begin;
+
+    const std::uint64_t h = std::hash<std::string_view>{}(
+        key.substr(skip + width));
+    return begin + static_cast<size_t>(
+                       (static_cast<unsigned __int128>(h) * (end - begin)) >>
+                       64);
+  }
+
+  /**
+   * Order-preserving prefix, i.e., the (end of string padded) codes of the
+   * width characters following the skipped common prefix packed in base
+   */
+  forceinline std::uint64_t prefix(const std::string_view &key) const {
+    std::uint64_t p = 0;
+    const size_t end = std::min(key.size(), skip + width);
+    for (size_t i = skip; i < end; i++)
+      p = p * base + codes[static_cast<unsigned char>(key[i])];
+    for (size_t i = std::max(end, skip); i < skip + width; i++) p *= base;
+    return p;
+  }
+
+  /// amount of skipped leading bytes
+  size_t skipped_bytes() const { return skip; }
+
+  /// amount of characters packed into a prefix
+  size_t prefix_width() const { return width; }
+
+  size_t model_count() const { return fn.model_count(); }
+
+  size_t byte_size() const {
+    return sizeof(*this) - sizeof(fn) + fn.byte_size() +
+           tie_prefixes.size() * sizeof(std::uint64_t) +
+           tie_ends.size() * sizeof(size_t);
+  }
+
+  static std::string name() {
+    return "string_" +
+           (Skip == learned_skip ? std::string("learned")
+                                 : std::to_string(Skip)) +
+           "skip_" + Hashfn::name();
+  }
+};
+}  // namespace learned_hashing
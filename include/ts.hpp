@@ -1,18 +1,22 @@
 #pragma once
 
+#include <memory>
+
+#include "convenience/allocator.hpp"
 #include "convenience/builtins.hpp"
 #include "ts/builder.h"
 #include "ts/ts.h"
 
 namespace learned_hashing {
-template <class Data, size_t max_error = 16>
+template <class Data, size_t max_error = 16,
+          class Allocator = std::allocator<Data>>
 class TrieSplineHash {
   /// output range is scaled from [0, sample_size) to [0, full_size) via this
   /// factor
   double _out_scale_fac;
 
   /// internal trie spline model, possibly trained on sample
-  ts::TrieSpline<Data> _spline;
+  ts::TrieSpline<Data, Allocator> _spline;
 
  public:
   TrieSplineHash() noexcept = default;
@@ -39,7 +43,7 @@ class TrieSplineHash {
     for (auto it = sample_begin; it < sample_end; it++) tsb.AddKey(*it);
 
     // actually build radix spline
-    _spline = tsb.Finalize();
+    _spline = tsb.template Finalize<Allocator>();
   }
 
   forceinline size_t operator()(const Data &key) const {
@@ -53,7 +57,8 @@ class TrieSplineHash {
   }
 
   static std::string name() {
-    return "trie_spline_err" + std::to_string(max_error);
+    return "trie_spline_err" + std::to_string(max_error) +
+           allocator_name<Allocator>();
   }
 };
 }  // namespace learned_hashing
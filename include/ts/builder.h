@@ -4,6 +4,7 @@
 #include <cmath>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <fstream>
 
@@ -38,7 +39,8 @@ class Builder {
   }
 
   // Finalizes the construction and returns a read-only `TrieSpline`.
-  TrieSpline<KeyType> Finalize() {
+  template <class Allocator = std::allocator<KeyType>>
+  TrieSpline<KeyType, Allocator> Finalize() {
     // Last key needs to be equal to `max_key_`.
     assert(curr_num_keys_ == 0 || prev_key_ == max_key_);
 
@@ -52,10 +54,11 @@ class Builder {
     auto tuning = InferTuning(statistics);
     
     // Finalize CHT
-    auto cht_ = chtb_.Finalize(tuning.numBins, tuning.treeMaxError);
+    auto cht_ = chtb_.template Finalize<Allocator>(tuning.numBins,
+                                                   tuning.treeMaxError);
 
     // And return the read-only instance
-    return TrieSpline<KeyType>(min_key_, max_key_, curr_num_keys_, spline_max_error_,
+    return TrieSpline<KeyType, Allocator>(min_key_, max_key_, curr_num_keys_, spline_max_error_,
                                std::move(cht_), std::move(spline_points_));
   }
 
@@ -3,28 +3,49 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
+#include <memory>
 #include <vector>
 
+#include "../convenience/allocator.hpp"
+#include "../convenience/simd.hpp"
 #include "common.h"
 #include "ts_cht/cht.h"
 
 namespace ts {
 // Approximates a cumulative distribution function (CDF) using spline
 // interpolation.
-template <class KeyType>
+template <class KeyType, class Allocator = std::allocator<KeyType>>
 class TrieSpline {
+  template <class T>
+  using Vector =
+      std::vector<T, learned_hashing::rebind_alloc_t<Allocator, T>>;
+
  public:
   TrieSpline() = default;
 
   TrieSpline(KeyType min_key, KeyType max_key, size_t num_keys,
-             size_t spline_max_error, ts_cht::CompactHistTree<KeyType> cht,
+             size_t spline_max_error,
+             ts_cht::CompactHistTree<KeyType, Allocator> cht,
              std::vector<ts::Coord<KeyType>> spline_points)
       : min_key_(min_key),
         max_key_(max_key),
         num_keys_(num_keys),
         spline_max_error_(spline_max_error),
-        spline_points_(std::move(spline_points)),
-        cht_(std::move(cht)) {}
+        cht_(std::move(cht)) {
+    spline_x_.reserve(spline_points.size() +
+                      learned_hashing::simd::scan_padding<KeyType>);
+    spline_y_.reserve(spline_points.size());
+    for (const auto& point : spline_points) {
+      spline_x_.push_back(point.x);
+      spline_y_.push_back(point.y);
+    }
+
+    // Sentinels allow for scanning past the last spline point.
+    spline_x_.resize(
+        spline_points.size() + learned_hashing::simd::scan_padding<KeyType>,
+        std::numeric_limits<KeyType>::max());
+  }
 
   // Returns the estimated position of `key`.
   double GetEstimatedPosition(const KeyType key) const {
@@ -34,8 +55,8 @@ class TrieSpline {
 
     // Find spline segment with `key` ∈ (spline[index - 1], spline[index]].
     const size_t index = GetSplineSegment(key);
-    const Coord<KeyType> down = spline_points_[index - 1];
-    const Coord<KeyType> up = spline_points_[index];
+    const Coord<KeyType> down = {spline_x_[index - 1], spline_y_[index - 1]};
+    const Coord<KeyType> up = {spline_x_[index], spline_y_[index]};
 
     // Compute slope.
     const double x_diff = up.x - down.x;
@@ -62,10 +83,11 @@ class TrieSpline {
   // Returns the size in bytes.
   size_t GetSize() const {
     return sizeof(*this) + cht_.GetSize() +
-           spline_points_.size() * sizeof(Coord<KeyType>);
+           spline_x_.size() * sizeof(KeyType) +
+           spline_y_.size() * sizeof(double);
   }
 
-  size_t SplinePointsCount() const { return spline_points_.size(); }
+  size_t SplinePointsCount() const { return spline_y_.size(); }
 
  private:
   // Returns the index of the spline point that marks the end of the spline
@@ -76,20 +98,15 @@ class TrieSpline {
 
     // Linear search?
     if (range.end - range.begin < 32) {
-      // Do linear search over narrowed range.
-      uint32_t current = range.begin;
-      while (spline_points_[current].x < key) ++current;
-      return current;
+      // Do (SIMD) linear search over narrowed range.
+      return range.begin + learned_hashing::simd::scan_lower_bound(
+                               spline_x_.data() + range.begin, key);
     }
 
     // Do binary search over narrowed range.
-    const auto lb =
-        std::lower_bound(spline_points_.begin() + range.begin,
-                         spline_points_.begin() + range.end, key,
-                         [](const Coord<KeyType>& coord, const KeyType key) {
-                           return coord.x < key;
-                         });
-    return std::distance(spline_points_.begin(), lb);
+    const auto lb = std::lower_bound(spline_x_.begin() + range.begin,
+                                     spline_x_.begin() + range.end, key);
+    return std::distance(spline_x_.begin(), lb);
   }
 
   KeyType min_key_;
@@ -97,8 +114,11 @@ class TrieSpline {
   size_t num_keys_;
   size_t spline_max_error_;
 
-  std::vector<ts::Coord<KeyType>> spline_points_;
-  ts_cht::CompactHistTree<KeyType> cht_;
+  // Spline points' x coordinates (padded with sentinels) and y coordinates in
+  // separate arrays, i.e., searches only touch the x coordinates.
+  Vector<KeyType> spline_x_;
+  Vector<double> spline_y_;
+  ts_cht::CompactHistTree<KeyType, Allocator> cht_;
 };
 
 }  // namespace ts
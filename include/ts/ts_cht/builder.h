@@ -3,6 +3,7 @@
 #include <cassert>
 #include <cmath>
 #include <limits>
+#include <memory>
 
 #include "cht.h"
 #include "common.h"
@@ -33,7 +34,9 @@ class Builder {
   }
 
   // Finalizes the construction and returns a read-only `RadixSpline`.
-  CompactHistTree<KeyType> Finalize(size_t num_bins, size_t max_error) {
+  template <class Allocator = std::allocator<KeyType>>
+  CompactHistTree<KeyType, Allocator> Finalize(size_t num_bins,
+                                               size_t max_error) {
     // Last key needs to be equal to `max_key_`.
     assert((!curr_num_keys_) || (prev_key_ == max_key_));
 
@@ -59,9 +62,9 @@ class Builder {
     bool single_layer = Flatten();
 
     // And return the adaptive CHT.
-    return CompactHistTree<KeyType>(single_layer, min_key_, max_key_, curr_num_keys_,
-                                    num_bins_, log_num_bins_, max_error_,
-                                    shift_, std::move(table_));
+    return CompactHistTree<KeyType, Allocator>(
+        single_layer, min_key_, max_key_, curr_num_keys_, num_bins_,
+        log_num_bins_, max_error_, shift_, std::move(table_));
   }
 
  private:
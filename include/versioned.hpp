@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "convenience/builtins.hpp"
+
+namespace learned_hashing {
+/**
+ * Hash function whose model can be replaced (e.g., retrained on a fresh
+ * sample to follow a drifting key distribution) while other threads keep
+ * hashing. Readers are wait-free and never block on retraining; the new model
+ * is built outside of any critical section and published atomically.
+ *
+ * Replaced models are reclaimed via epoch-based reclamation: each reader
+ * announces the global epoch it observed in its own slot before loading the
+ * current model and clears the slot afterwards. Publishing swaps the model,
+ * advances the epoch and retires the old model with the new epoch. A retired
+ * model is freed once no slot announces an older epoch, since readers that
+ * announced the new epoch (or later) are guaranteed to load the new model.
+ * Reclamation never waits for readers, i.e., models still in use remain
+ * retired until a later publish() or reclaim().
+ *
+ * Readers hash through a Reader handle owning one of MaxReaders slots.
+ *
+ * @tparam Hashfn hash function to version
+ * @tparam MaxReaders maximum amount of concurrently registered readers
+ */
+template <class Hashfn, size_t MaxReaders = 64>
+class VersionedHash {
+  /// slot value of readers not currently hashing
+  static constexpr std::uint64_t idle =
+      std::numeric_limits<std::uint64_t>::max();
+
+  /// each reader slot on its own cache line to avoid false sharing
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> epoch{idle};
+    std::atomic<bool> registered{false};
+  };
+
+  struct Retired {
+    const Hashfn *fn;
+    std::uint64_t epoch;
+  };
+
+  std::atomic<const Hashfn *> current{nullptr};
+  std::atomic<std::uint64_t> epoch{0};
+  std::array<Slot, MaxReaders> slots;
+
+  /// serializes writers (publish, reclaim). Never taken by readers
+  std::mutex writer_mutex;
+  std::vector<Retired> retired;
+
+ public:
+  /// Wait-free hashing handle owning a reader slot. Must not outlive the
+  /// VersionedHash it was obtained from and must only be used by one thread
+  /// at a time
+  class Reader {
+    const VersionedHash *versioned = nullptr;
+    Slot *slot = nullptr;
+
+    friend class VersionedHash;
+    Reader(const VersionedHash *versioned, Slot *slot)
+        : versioned(versioned), slot(slot) {}
+
+   public:
+    Reader() = default;
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+    Reader(Reader &&other) noexcept
+        : versioned(std::exchange(other.versioned, nullptr)),
+          slot(std::exchange(other.slot, nullptr)) {}
+    Reader &operator=(Reader &&other) noexcept {
+      std::swap(versioned, other.versioned);
+      std::swap(slot, other.slot);
+      return *this;
+    }
+    ~Reader() {
+      if (slot != nullptr) slot->registered.store(false);
+    }
+
+    template <class Key>
+    forceinline size_t operator()(const Key &key) const {
+      // announcing and loading are sequentially consistent: a writer that
+      // does not observe the announcement must have published before the
+      // model load below
+      slot->epoch.store(versioned->epoch.load());
+      const auto result = (*versioned->current.load())(key);
+      slot->epoch.store(idle, std::memory_order_release);
+      return result;
+    }
+  };
+
+  VersionedHash() : current(new Hashfn()) {}
+
+  template <class RandomIt>
+  VersionedHash(const RandomIt &sample_begin, const RandomIt &sample_end,
+                const size_t full_size)
+      : current(new Hashfn(sample_begin, sample_end, full_size)) {}
+
+  VersionedHash(const VersionedHash &) = delete;
+  VersionedHash &operator=(const VersionedHash &) = delete;
+
+  /// all Readers must have been destroyed
+  ~VersionedHash() {
+#ifndef NDEBUG
+    for (const auto &slot : slots) assert(!slot.registered.load());
+#endif
+    for (const auto &r : retired) delete r.fn;
+    delete current.load();
+  }
+
+  /// registers a new reader. Throws if all MaxReaders slots are in use
+  Reader reader() {
+    for (auto &slot : slots) {
+      bool expected = false;
+      if (!slot.registered.load(std::memory_order_relaxed) &&
+          slot.registered.compare_exchange_strong(expected, true))
+        return Reader(this, &slot);
+    }
+    throw std::runtime_error("all " + std::to_string(MaxReaders) +
+                             " reader slots are in use");
+  }
+
+  /**
+   * Trains a new model on [sample_begin, sample_end) and publishes it. May be
+   * called while readers are hashing. Training happens before any
+   * synchronization, i.e., only publishing is serialized with other writers
+   */
+  template <class RandomIt>
+  void retrain(const RandomIt &sample_begin, const RandomIt &sample_end,
+               const size_t full_size) {
+    publish(std::make_unique<Hashfn>(sample_begin, sample_end, full_size));
+  }
+
+  /// atomically replaces the current model and reclaims unused old ones
+  void publish(std::unique_ptr<Hashfn> next) {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    const auto old = current.exchange(next.release());
+    retired.push_back({old, epoch.fetch_add(1) + 1});
+    reclaim_locked();
+  }
+
+  /// frees retired models no reader can still be using
+  void reclaim() {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    reclaim_locked();
+  }
+
+  /// amount of models published since construction
+  std::uint64_t version() const { return epoch.load(); }
+
+  /// amount of replaced models that could not yet be freed
+  size_t retired_count() {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    return retired.size();
+  }
+
+  size_t model_count() const { return current.load()->model_count(); }
+
+  size_t byte_size() const {
+    return sizeof(*this) + current.load()->byte_size();
+  }
+
+  static std::string name() { return "versioned_" + Hashfn::name(); }
+
+ private:
+  void reclaim_locked() {
+    std::uint64_t min_active = idle;
+    for (const auto &slot : slots)
+      min_active = std::min(min_active, slot.epoch.load());
+
+    const auto reclaimable = [&](const Retired &r) {
+      if (r.epoch > min_active) return false;
+      delete r.fn;
+      return true;
+    };
+    retired.erase(std::remove_if(retired.begin(), retired.end(), reclaimable),
+                  retired.end());
+  }
+};
+}  // namespace learned_hashing
@@ -1,11 +1,24 @@
 #pragma once
 
+#include "include/auto.hpp"
+#include "include/chained-table.hpp"
 #include "include/cht.hpp"
+#include "include/cuckoo-table.hpp"
+#include "include/drift.hpp"
 #include "include/dynamic-pgm.hpp"
+#include "include/encoded.hpp"
+#include "include/hybrid.hpp"
+#include "include/monotone-table.hpp"
+#include "include/partition.hpp"
 #include "include/pgm.hpp"
+#include "include/quality.hpp"
 #include "include/rmi.hpp"
 #include "include/rs.hpp"
+#include "include/search.hpp"
+#include "include/sort.hpp"
+#include "include/string.hpp"
 #include "include/ts.hpp"
+#include "include/versioned.hpp"
 
 // Order is important
 #include "include/convenience/undef.hpp"
@@ -5,8 +5,32 @@ import os
 import concurrent.futures
 import numpy as np
 
+def read_columnar(path):
+    """loads a binary table written by lh_stats (see src/support/columnar.hpp)"""
+    with open(path, 'rb') as f:
+        buf = f.read()
+    if buf[:8] != b'LHCOLS01':
+        raise ValueError(f"{path} is not a columnar stats file")
+
+    row_cnt, column_cnt = (int(v) for v in np.frombuffer(buf, '<u8', 2, 8))
+    offset = 24
+    columns = []
+    for _ in range(column_cnt):
+        name_len = int(np.frombuffer(buf, '<u8', 1, offset)[0])
+        offset += 8
+        name = buf[offset:offset + name_len].decode()
+        offset += name_len
+        columns.append((name, '<f8' if buf[offset:offset + 1] == b'f' else '<u8'))
+        offset += 1
+
+    data = {}
+    for name, dtype in columns:
+        data[name] = np.frombuffer(buf, dtype, row_cnt, offset)
+        offset += 8 * row_cnt
+    return pd.DataFrame(data)
+
 def plot(ds):
-    df = pd.read_csv(ds)
+    df = read_columnar(ds) if ds.endswith('.bin') else pd.read_csv(ds)
     if 'models' in ds.lower():
         fig = px.line(df, x='x', y='y', title=f"{ds} ({len(df)} datapoints)")
         fig.write_image(f"{os.path.splitext(ds)[0]}.png", scale=4)
@@ -15,7 +39,7 @@ def plot(ds):
         fig.write_image(f"{os.path.splitext(ds)[0]}.png", scale=4)
 
 if len(sys.argv) < 2:
-    print("Please specify the csv files to plot")
+    print("Please specify the .bin (or .csv) files to plot")
     exit(-1)
 
 executor = concurrent.futures.ProcessPoolExecutor(20)
@@ -1,11 +1,22 @@
 #include <benchmark/benchmark.h>
 
+#include <array>
+#include <atomic>
+#include <bit>
 #include <chrono>
 #include <cstdint>
 #include <learned_hashing.hpp>
+#include <map>
+#include <mutex>
 #include <random>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 #include "./support/datasets.hpp"
+#include "./support/perf_counters.hpp"
 #include "./support/probing_set.hpp"
 
 const std::vector<std::int64_t> throughput_ds_sizes{1'000'000, 10'000'000,
@@ -20,6 +31,13 @@ const std::vector<std::int64_t> datasets{
     static_cast<std::underlying_type_t<dataset::ID>>(dataset::ID::FB),
     static_cast<std::underlying_type_t<dataset::ID>>(dataset::ID::OSM),
     static_cast<std::underlying_type_t<dataset::ID>>(dataset::ID::WIKI)};
+// sosd only provides books with 32 bit keys
+const std::vector<std::int64_t> datasets32{
+    static_cast<std::underlying_type_t<dataset::ID>>(dataset::ID::SEQUENTIAL),
+    static_cast<std::underlying_type_t<dataset::ID>>(dataset::ID::GAPPED_10),
+    static_cast<std::underlying_type_t<dataset::ID>>(dataset::ID::UNIFORM),
+    static_cast<std::underlying_type_t<dataset::ID>>(dataset::ID::NORMAL),
+    static_cast<std::underlying_type_t<dataset::ID>>(dataset::ID::BOOKS)};
 const std::vector<std::int64_t> probe_distributions{
     static_cast<std::underlying_type_t<dataset::ProbingDistribution>>(
         dataset::ProbingDistribution::UNIFORM),
@@ -27,14 +45,23 @@ const std::vector<std::int64_t> probe_distributions{
         dataset::ProbingDistribution::EXPONENTIAL)};
 const std::vector<std::int64_t> sample_sizes{1, 100};
 
-template <class Hashfn>
+/// exports hardware counters (if available) normalized per lookup
+static void export_perf_counters(benchmark::State& state,
+                                 const perf::Counters& counters,
+                                 const size_t lookups) {
+  if (lookups == 0) return;
+  for (const auto& [name, value] : counters.read())
+    state.counters[name + "_per_lookup"] = value / static_cast<double>(lookups);
+}
+
+template <class Hashfn, class Key = std::uint64_t>
 static void BM_build_and_throughput(benchmark::State& state) {
   const auto ds_size = state.range(0);
   const auto ds_id = static_cast<dataset::ID>(state.range(1));
   const double sample_size = static_cast<double>(state.range(2)) / 100.0;
 
   // load dataset
-  auto dataset = dataset::load_cached(ds_id, ds_size);
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
   if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
 
   // shuffle dataset to pick sample uniform randomly
@@ -67,6 +94,8 @@ static void BM_build_and_throughput(benchmark::State& state) {
   // overhead due to gbench is too high for meaningful measurements of the
   // fastest hashfns.
   size_t i = 0;
+  perf::Counters perf_counters;
+  perf_counters.start();
   for (auto _ : state) {
     // get next lookup element
     while (unlikely(i >= probing_set.size())) i -= probing_set.size();
@@ -79,6 +108,8 @@ static void BM_build_and_throughput(benchmark::State& state) {
     // prevent interleaved execution
     __sync_synchronize();
   }
+  perf_counters.stop();
+  export_perf_counters(state, perf_counters, state.iterations());
 
   state.counters["shuffle_time"] =
       std::chrono::duration<double>(shuffle_end_time - shuffle_start_time)
@@ -97,7 +128,28 @@ static void BM_build_and_throughput(benchmark::State& state) {
   state.counters["hashfn_byte_size"] = hashfn.byte_size();
   state.counters["hashfn_model_count"] = hashfn.model_count();
 
-  state.SetLabel(Hashfn::name() + ":" + dataset::name(ds_id) + ":" +
+  std::string name = Hashfn::name();
+  if constexpr (requires { hashfn.tuning_report(); }) {
+    const auto& report = hashfn.tuning_report();
+    state.counters["tuning_time"] =
+        std::chrono::duration<double>(report.tuning_time).count();
+    state.counters["tuning_time_budget_exceeded"] =
+        report.time_budget_exceeded;
+    name += "(" + hashfn.selected_name() + ")";
+  }
+  if constexpr (requires { hashfn.routed_key_fraction(); }) {
+    state.counters["routed_key_fraction"] = hashfn.routed_key_fraction();
+    state.counters["routed_region_fraction"] = hashfn.routed_region_fraction();
+  }
+  if constexpr (requires { hashfn.drift_stats(); }) {
+    const auto stats = hashfn.drift_stats();
+    state.counters["drift_sampled"] = stats.sampled;
+    state.counters["drift_kl_divergence"] = stats.kl_divergence;
+    state.counters["drift_max_load"] = stats.max_load;
+    state.counters["drift_needs_retrain"] = stats.needs_retrain;
+  }
+
+  state.SetLabel(name + ":" + dataset::name(ds_id) + ":" +
                  dataset::name(probing_dist));
 
   state.SetItemsProcessed(static_cast<size_t>(state.iterations()));
@@ -105,14 +157,14 @@ static void BM_build_and_throughput(benchmark::State& state) {
                           sizeof(typename decltype(dataset)::value_type));
 }
 
-template <class Hashfn>
+template <class Hashfn, class Key = std::uint64_t>
 static void BM_scattering(benchmark::State& state) {
   const auto ds_size = state.range(0);
   const auto ds_id = static_cast<dataset::ID>(state.range(1));
   const double sample_size = static_cast<double>(state.range(2)) / 100.0;
 
   // load dataset
-  auto dataset = dataset::load_cached(ds_id, ds_size);
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
   if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
 
   // shuffle dataset to pick sample uniform randomly
@@ -131,6 +183,8 @@ static void BM_scattering(benchmark::State& state) {
 
   const Hashfn hashfn(sample.begin(), sample.end(), N);
 
+  perf::Counters perf_counters;
+  perf_counters.start();
   for (auto _ : state) {
     for (const auto& key : dataset) {
       const auto pred_rank = hashfn(key);
@@ -138,6 +192,10 @@ static void BM_scattering(benchmark::State& state) {
       buckets[rank]++;
     }
   }
+  perf_counters.stop();
+  export_perf_counters(
+      state, perf_counters,
+      dataset.size() * static_cast<size_t>(state.iterations()));
 
   for (size_t i = 0; i < N; i++)
     state.counters["bucket_" + std::to_string(i)] = buckets[i];
@@ -156,15 +214,1037 @@ static void BM_scattering(benchmark::State& state) {
                           sizeof(typename decltype(dataset)::value_type));
 }
 
-#define BM(Hashfn)                                                            \
-  BENCHMARK_TEMPLATE(BM_scattering, Hashfn)                                   \
-      ->ArgsProduct({scattering_ds_sizes, datasets, sample_sizes})            \
-      ->Iterations(1);                                                        \
-  BENCHMARK_TEMPLATE(BM_build_and_throughput, Hashfn)                         \
+/// classical baseline for BM_partitioning, i.e., radix partitioning on the
+/// most significant bits of the sample's key range
+struct RadixPartitioning {
+  static std::string name() { return "radix"; }
+};
+
+template <class Hashfn>
+static void BM_partitioning(benchmark::State& state) {
+  using Key = std::uint64_t;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const auto partition_count = static_cast<size_t>(state.range(2));
+  const auto thread_count = static_cast<size_t>(state.range(3));
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  // 1% sample
+  std::vector<Key> sample(dataset.begin(),
+                          dataset.begin() + std::max<size_t>(
+                                                1, dataset.size() / 100));
+  std::sort(sample.begin(), sample.end());
+
+  std::vector<Key> out;
+  std::vector<size_t> offsets;
+  if constexpr (std::is_same_v<Hashfn, RadixPartitioning>) {
+    // partition_count is a power of two
+    const Key min = sample.front();
+    const size_t range_bits = 64 - std::countl_zero(sample.back() - min);
+    const size_t partition_bits = std::countr_zero(partition_count);
+    const size_t shift =
+        range_bits > partition_bits ? range_bits - partition_bits : 0;
+    const auto radix = [&](const Key& key) {
+      return key < min ? 0 : static_cast<size_t>((key - min) >> shift);
+    };
+    for (auto _ : state)
+      offsets = learned_hashing::partition_by(radix, dataset, partition_count,
+                                              out, thread_count);
+  } else {
+    const Hashfn hashfn(sample.begin(), sample.end(), dataset.size());
+    for (auto _ : state)
+      offsets = learned_hashing::learned_partition(
+          hashfn, dataset, partition_count, out, thread_count);
+    state.counters["hashfn_byte_size"] = hashfn.byte_size();
+  }
+
+  // partition balance relative to a perfectly balanced partitioning
+  size_t min_size = dataset.size(), max_size = 0;
+  for (size_t p = 0; p < partition_count; p++) {
+    min_size = std::min(min_size, offsets[p + 1] - offsets[p]);
+    max_size = std::max(max_size, offsets[p + 1] - offsets[p]);
+  }
+  const double balanced = static_cast<double>(dataset.size()) / partition_count;
+  state.counters["min_partition_ratio"] = min_size / balanced;
+  state.counters["max_partition_ratio"] = max_size / balanced;
+  state.counters["dataset_size"] = dataset.size();
+
+  state.SetLabel(Hashfn::name() + ":" + dataset::name(ds_id) + ":" +
+                 std::to_string(partition_count) + ":threads" +
+                 std::to_string(thread_count));
+  state.SetItemsProcessed(dataset.size() *
+                          static_cast<size_t>(state.iterations()));
+  state.SetBytesProcessed(dataset.size() *
+                          static_cast<size_t>(state.iterations()) *
+                          sizeof(Key));
+}
+
+/// std::sort baseline for BM_sorting
+struct StdSort {
+  template <class It>
+  static void sort(const It& begin, const It& end, const size_t) {
+    std::sort(begin, end);
+  }
+
+  static std::string name() { return "std_sort"; }
+};
+
+/// single threaded LSD radix sort baseline (8 bit digits) for BM_sorting.
+/// Digits shared by all keys are skipped
+struct RadixSort {
+  template <class It>
+  static void sort(const It& begin, const It& end, const size_t) {
+    using Key = typename std::iterator_traits<It>::value_type;
+    constexpr size_t digits = sizeof(Key);
+    const size_t n = std::distance(begin, end);
+
+    std::array<std::array<size_t, 256>, digits> histograms{};
+    for (auto it = begin; it < end; it++)
+      for (size_t d = 0; d < digits; d++)
+        histograms[d][(*it >> (8 * d)) & 0xFF]++;
+
+    std::vector<Key> buffer(n);
+    Key* from = &*begin;
+    Key* to = buffer.data();
+    for (size_t d = 0; d < digits; d++) {
+      auto& histogram = histograms[d];
+      if (std::count(histogram.begin(), histogram.end(), n) == 1) continue;
+
+      size_t offset = 0;
+      for (auto& count : histogram) offset += std::exchange(count, offset);
+      for (size_t i = 0; i < n; i++)
+        to[histogram[(from[i] >> (8 * d)) & 0xFF]++] = from[i];
+      std::swap(from, to);
+    }
+    if (from != &*begin) std::copy(from, from + n, begin);
+  }
+
+  static std::string name() { return "radix_sort"; }
+};
+
+template <class Hashfn>
+struct LearnedSort {
+  template <class It>
+  static void sort(const It& begin, const It& end, const size_t threads) {
+    learned_hashing::learned_sort<Hashfn>(begin, end, threads);
+  }
+
+  static std::string name() { return "learned_sort_" + Hashfn::name(); }
+};
+
+template <class Sorter>
+static void BM_sorting(benchmark::State& state) {
+  using Key = std::uint64_t;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const auto thread_count = static_cast<size_t>(state.range(2));
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  std::vector<Key> keys;
+  for (auto _ : state) {
+    state.PauseTiming();
+    keys = dataset;
+    state.ResumeTiming();
+
+    Sorter::sort(keys.begin(), keys.end(), thread_count);
+  }
+  if (!std::is_sorted(keys.begin(), keys.end()))
+    throw std::runtime_error(Sorter::name() + " did not sort");
+
+  state.counters["dataset_size"] = dataset.size();
+  state.SetLabel(Sorter::name() + ":" + dataset::name(ds_id) + ":threads" +
+                 std::to_string(thread_count));
+  state.SetItemsProcessed(dataset.size() *
+                          static_cast<size_t>(state.iterations()));
+}
+
+/// std::lower_bound baseline for BM_lower_bound
+struct StdLowerBound {
+  template <class It>
+  StdLowerBound(const It&, const It&, const size_t) {}
+
+  template <class Keys>
+  void measure_error(const Keys&) {}
+
+  template <class Keys>
+  forceinline size_t lower_bound(const Keys& sorted_data,
+                                 const typename Keys::value_type& key) const {
+    return std::lower_bound(sorted_data.begin(), sorted_data.end(), key) -
+           sorted_data.begin();
+  }
+
+  static std::string name() { return "std_lower_bound"; }
+  size_t byte_size() const { return 0; }
+  size_t model_count() const { return 0; }
+};
+
+/// searches within RMIHash::bounds(), i.e., exact per model error bounds
+template <class RMI>
+struct RMIBoundsSearch {
+  RMI rmi;
+
+  template <class It>
+  RMIBoundsSearch(const It& sample_begin, const It& sample_end,
+                  const size_t full_size)
+      : rmi(sample_begin, sample_end, full_size) {}
+
+  template <class Keys>
+  void measure_error(const Keys& sorted_data) {
+    rmi.measure_errors(sorted_data.begin(), sorted_data.end());
+  }
+
+  template <class Keys>
+  forceinline size_t lower_bound(const Keys& sorted_data,
+                                 const typename Keys::value_type& key) const {
+    const auto bounds = rmi.bounds(key);
+    return learned_hashing::branchless_lower_bound(
+               sorted_data.data() + bounds.begin,
+               sorted_data.data() + bounds.end, key) -
+           sorted_data.data();
+  }
+
+  static std::string name() { return "bounds_" + RMI::name(); }
+  size_t byte_size() const { return rmi.byte_size(); }
+  size_t model_count() const { return rmi.model_count(); }
+};
+
+/// point lookups in sorted data, i.e., learned hash functions as index
+template <class Searcher>
+static void BM_lower_bound(benchmark::State& state) {
+  using Key = std::uint64_t;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const double sample_size = static_cast<double>(state.range(2)) / 100.0;
+  const auto probing_dist =
+      static_cast<dataset::ProbingDistribution>(state.range(3));
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+  std::vector<Key> sample(dataset.begin(),
+                          dataset.begin() + dataset.size() * sample_size);
+  std::sort(sample.begin(), sample.end());
+  const auto probing_set = dataset::generate_probing_set(dataset, probing_dist);
+  std::sort(dataset.begin(), dataset.end());
+
+  const auto build_start_time = std::chrono::steady_clock::now();
+  Searcher searcher(sample.begin(), sample.end(), dataset.size());
+  const auto build_end_time = std::chrono::steady_clock::now();
+  searcher.measure_error(dataset);
+  const auto measure_end_time = std::chrono::steady_clock::now();
+
+  size_t i = 0;
+  for (auto _ : state) {
+    while (unlikely(i >= probing_set.size())) i -= probing_set.size();
+    const auto key = probing_set[i++];
+
+    const auto pos = searcher.lower_bound(dataset, key);
+    benchmark::DoNotOptimize(pos);
+
+    // prevent interleaved execution
+    __sync_synchronize();
+  }
+
+  state.counters["build_time"] =
+      std::chrono::duration<double>(build_end_time - build_start_time).count();
+  state.counters["measure_error_time"] =
+      std::chrono::duration<double>(measure_end_time - build_end_time).count();
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["sample_size"] = sample_size;
+  state.counters["searcher_byte_size"] = searcher.byte_size();
+  state.counters["searcher_model_count"] = searcher.model_count();
+  if constexpr (requires { searcher.max_measured_error(); }) {
+    state.counters["min_error"] = searcher.min_measured_error();
+    state.counters["max_error"] = searcher.max_measured_error();
+  }
+
+  state.SetLabel(Searcher::name() + ":" + dataset::name(ds_id) + ":" +
+                 dataset::name(probing_dist));
+  state.SetItemsProcessed(static_cast<size_t>(state.iterations()));
+}
+
+/// B-tree baseline for BM_monotone_table, i.e., an implicit B+-tree over the
+/// sorted keys with payloads stored separately
+struct BTreeTable {
+  using Key = std::uint64_t;
+  learned_hashing::_rs::StaticBTree<Key> tree;
+  std::vector<std::uint64_t> payloads;
+
+  template <class It>
+  BTreeTable(const It&, const It&, const std::vector<Key>& sorted_keys)
+      : tree(sorted_keys), payloads(sorted_keys.size()) {
+    for (size_t i = 0; i < payloads.size(); i++) payloads[i] = i;
+  }
+
+  forceinline const std::uint64_t* lookup(const Key& key) const {
+    const size_t pos = tree.LowerBound(key);
+    return pos < tree.size() && tree[pos] == key ? &payloads[pos] : nullptr;
+  }
+
+  template <class Fn>
+  forceinline void range(const Key& lo, const Key& hi, const Fn& fn) const {
+    for (size_t pos = tree.LowerBound(lo); pos < tree.size() && tree[pos] < hi;
+         pos++)
+      fn(tree[pos], payloads[pos]);
+  }
+
+  size_t byte_size() const {
+    return tree.GetSize() + payloads.size() * sizeof(std::uint64_t);
+  }
+  static std::string name() { return "static_btree"; }
+};
+
+/// learned_hashing::MonotoneHashTable with one slot per key
+template <class Hashfn>
+struct MonotoneTable {
+  using Key = std::uint64_t;
+  learned_hashing::MonotoneHashTable<Key, std::uint64_t, Hashfn> table;
+
+  template <class It>
+  MonotoneTable(const It& sample_begin, const It& sample_end,
+                const std::vector<Key>& sorted_keys)
+      : table(sample_begin, sample_end, sorted_keys.size()) {
+    for (size_t i = 0; i < sorted_keys.size(); i++)
+      table.insert(sorted_keys[i], i);
+  }
+
+  forceinline const std::uint64_t* lookup(const Key& key) const {
+    return table.lookup(key);
+  }
+
+  template <class Fn>
+  forceinline void range(const Key& lo, const Key& hi, const Fn& fn) const {
+    table.range(lo, hi, fn);
+  }
+
+  size_t overflow_count() const { return table.overflow_count(); }
+  size_t byte_size() const { return table.byte_size(); }
+  static std::string name() { return decltype(table)::name(); }
+};
+
+/// point lookups (scan_length 0) or range scans over scan_length keys on
+/// ordered tables
+template <class Table>
+static void BM_monotone_table(benchmark::State& state) {
+  using Key = std::uint64_t;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const auto scan_length = static_cast<size_t>(state.range(2));
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+
+  // 1% sample
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+  std::vector<Key> sample(dataset.begin(),
+                          dataset.begin() + dataset.size() / 100 + 1);
+  std::sort(sample.begin(), sample.end());
+  std::sort(dataset.begin(), dataset.end());
+  dataset.erase(std::unique(dataset.begin(), dataset.end()), dataset.end());
+
+  const auto build_start_time = std::chrono::steady_clock::now();
+  const Table table(sample.begin(), sample.end(), dataset);
+  const auto build_end_time = std::chrono::steady_clock::now();
+
+  // queries [lo, hi) spanning scan_length keys
+  std::vector<std::pair<Key, Key>> queries(1 << 20);
+  std::uniform_int_distribution<size_t> dist(0, dataset.size() - 1);
+  for (auto& [lo, hi] : queries) {
+    const size_t pos = dist(rng);
+    lo = dataset[pos];
+    hi = pos + scan_length < dataset.size() ? dataset[pos + scan_length]
+                                            : dataset.back();
+  }
+
+  size_t i = 0, scanned = 0;
+  for (auto _ : state) {
+    while (unlikely(i >= queries.size())) i -= queries.size();
+    const auto& [lo, hi] = queries[i++];
+
+    if (scan_length == 0) {
+      const auto* payload = table.lookup(lo);
+      benchmark::DoNotOptimize(payload);
+    } else {
+      std::uint64_t sum = 0;
+      table.range(lo, hi, [&](const Key&, const std::uint64_t& payload) {
+        sum += payload;
+        scanned++;
+      });
+      benchmark::DoNotOptimize(sum);
+    }
+
+    // prevent interleaved execution
+    __sync_synchronize();
+  }
+
+  state.counters["build_time"] =
+      std::chrono::duration<double>(build_end_time - build_start_time).count();
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["table_byte_size"] = table.byte_size();
+  state.counters["scanned_per_query"] =
+      static_cast<double>(scanned) / state.iterations();
+  if constexpr (requires { table.overflow_count(); })
+    state.counters["overflow_fraction"] =
+        static_cast<double>(table.overflow_count()) / dataset.size();
+
+  state.SetLabel(Table::name() + ":" + dataset::name(ds_id) + ":scan" +
+                 std::to_string(scan_length));
+  state.SetItemsProcessed(static_cast<size_t>(state.iterations()));
+}
+
+/// lookups on a cuckoo table filled to load_percent, either one at a time or
+/// batched (prefetching all buckets of a batch first). Reports displacements
+/// per key & stash size of the fill
+template <class Hashfn>
+static void BM_cuckoo_table(benchmark::State& state) {
+  using Key = std::uint64_t;
+  using Table = learned_hashing::CuckooHashTable<Key, std::uint64_t, Hashfn>;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const auto load_factor = static_cast<double>(state.range(2)) / 100.0;
+  const bool batched = state.range(3) != 0;
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+  std::sort(dataset.begin(), dataset.end());
+  dataset.erase(std::unique(dataset.begin(), dataset.end()), dataset.end());
+
+  // 1% sample
+  std::vector<Key> sample;
+  for (size_t i = 0; i < dataset.size(); i += 100)
+    sample.push_back(dataset[i]);
+
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  const auto build_start_time = std::chrono::steady_clock::now();
+  Table table(sample.begin(), sample.end(), dataset.size() / load_factor);
+  for (const auto& key : dataset) table.insert(key, key);
+  const auto build_end_time = std::chrono::steady_clock::now();
+
+  // chunks of queries per iteration, i.e., whole batches
+  constexpr size_t chunk = 1024;
+  std::vector<Key> queries(1 << 20);
+  std::uniform_int_distribution<size_t> dist(0, dataset.size() - 1);
+  for (auto& query : queries) query = dataset[dist(rng)];
+  std::vector<const std::uint64_t*> results(chunk);
+
+  size_t i = 0;
+  for (auto _ : state) {
+    if (unlikely(i + chunk > queries.size())) i = 0;
+    const auto begin = queries.begin() + i;
+    i += chunk;
+
+    if (batched) {
+      table.lookup_batch(begin, begin + chunk, results.begin());
+    } else {
+      for (size_t j = 0; j < chunk; j++) results[j] = table.lookup(begin[j]);
+    }
+    benchmark::DoNotOptimize(results.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.counters["build_time"] =
+      std::chrono::duration<double>(build_end_time - build_start_time).count();
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["load_factor"] = table.load_factor();
+  state.counters["displacements_per_key"] =
+      static_cast<double>(table.displacement_count()) / dataset.size();
+  state.counters["stash_size"] = table.stash_size();
+  state.counters["primary_fraction"] =
+      static_cast<double>(table.primary_count()) / dataset.size();
+  state.counters["table_byte_size"] = table.byte_size();
+
+  state.SetLabel(Table::name() + ":" + dataset::name(ds_id) + ":" +
+                 (batched ? "batched" : "single"));
+  state.SetItemsProcessed(static_cast<size_t>(state.iterations()) * chunk);
+}
+
+/// learned_hashing::ChainedHashTable built via insert_batch
+template <class Hashfn>
+struct ChainedTable {
+  using Key = std::uint64_t;
+  learned_hashing::ChainedHashTable<Key, std::uint64_t, Hashfn> table;
+
+  template <class It>
+  ChainedTable(const It& sample_begin, const It& sample_end,
+               const std::vector<Key>& keys, const size_t bucket_count)
+      : table(sample_begin, sample_end, bucket_count) {
+    table.insert_batch(keys.begin(), keys.end(), keys.begin());
+  }
+
+  template <class InputIt, class OutputIt>
+  forceinline void lookup_batch(const InputIt& first, const InputIt& last,
+                                const OutputIt& out) const {
+    table.lookup_batch(first, last, out);
+  }
+
+  size_t chained_count() const { return table.chained_count(); }
+  size_t byte_size() const { return table.byte_size(); }
+  static std::string name() { return decltype(table)::name(); }
+};
+
+/// chaining baseline with one std::vector per bucket, i.e., an allocation
+/// (and copy) whenever a bucket grows
+template <class Hashfn>
+struct VectorChainedTable {
+  using Key = std::uint64_t;
+  Hashfn hashfn;
+  std::vector<std::vector<std::pair<Key, std::uint64_t>>> buckets;
+
+  template <class It>
+  VectorChainedTable(const It& sample_begin, const It& sample_end,
+                     const std::vector<Key>& keys, const size_t bucket_count)
+      : hashfn(sample_begin, sample_end, bucket_count),
+        buckets(bucket_count) {
+    for (const auto& key : keys) {
+      auto& bucket = buckets[std::min<size_t>(hashfn(key), bucket_count - 1)];
+      if (std::none_of(bucket.begin(), bucket.end(),
+                       [&](const auto& entry) { return entry.first == key; }))
+        bucket.emplace_back(key, key);
+    }
+  }
+
+  template <class InputIt, class OutputIt>
+  forceinline void lookup_batch(InputIt first, const InputIt& last,
+                                OutputIt out) const {
+    for (; first != last; ++first, ++out) {
+      const auto& bucket =
+          buckets[std::min<size_t>(hashfn(*first), buckets.size() - 1)];
+      *out = nullptr;
+      for (const auto& [key, payload] : bucket)
+        if (key == *first) {
+          *out = &payload;
+          break;
+        }
+    }
+  }
+
+  size_t byte_size() const {
+    size_t size = hashfn.byte_size() + buckets.size() * sizeof(buckets[0]);
+    for (const auto& bucket : buckets)
+      size += bucket.capacity() * sizeof(bucket[0]);
+    return size;
+  }
+  static std::string name() { return "vector_chained_" + Hashfn::name(); }
+};
+
+/// batched lookups on chained tables with load_percent keys per 100 buckets
+template <class Table>
+static void BM_chained_table(benchmark::State& state) {
+  using Key = std::uint64_t;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const auto load_factor = static_cast<double>(state.range(2)) / 100.0;
+  const auto probing_dist =
+      static_cast<dataset::ProbingDistribution>(state.range(3));
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+  std::sort(dataset.begin(), dataset.end());
+  dataset.erase(std::unique(dataset.begin(), dataset.end()), dataset.end());
+
+  // 1% sample
+  std::vector<Key> sample;
+  for (size_t i = 0; i < dataset.size(); i += 100)
+    sample.push_back(dataset[i]);
+
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  const auto build_start_time = std::chrono::steady_clock::now();
+  const Table table(sample.begin(), sample.end(), dataset,
+                    std::max<size_t>(1, dataset.size() / load_factor));
+  const auto build_end_time = std::chrono::steady_clock::now();
+
+  // chunks of probes per iteration, i.e., whole batches
+  constexpr size_t chunk = 1024;
+  const auto probing_set = dataset::generate_probing_set(dataset, probing_dist);
+  std::vector<const std::uint64_t*> results(chunk);
+
+  size_t i = 0;
+  for (auto _ : state) {
+    if (unlikely(i + chunk > probing_set.size())) i = 0;
+    const auto begin = probing_set.begin() + i;
+    i += chunk;
+
+    table.lookup_batch(begin, begin + chunk, results.begin());
+    benchmark::DoNotOptimize(results.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.counters["build_time"] =
+      std::chrono::duration<double>(build_end_time - build_start_time).count();
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["table_byte_size"] = table.byte_size();
+  if constexpr (requires { table.chained_count(); })
+    state.counters["chained_fraction"] =
+        static_cast<double>(table.chained_count()) / dataset.size();
+
+  state.SetLabel(Table::name() + ":" + dataset::name(ds_id) + ":" +
+                 dataset::name(probing_dist));
+  state.SetItemsProcessed(static_cast<size_t>(state.iterations()) * chunk);
+}
+
+template <class Hashfn, class Key = std::uint64_t>
+static void BM_quality(benchmark::State& state) {
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const double sample_size = static_cast<double>(state.range(2)) / 100.0;
+
+  // load dataset
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+
+  // shuffle dataset to pick sample uniform randomly
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  const auto sample_n = dataset.size() * sample_size;
+  std::vector<typename decltype(dataset)::value_type> sample(
+      dataset.begin(), dataset.begin() + sample_n);
+  std::sort(sample.begin(), sample.end());
+
+  // one slot per key
+  const Hashfn hashfn(sample.begin(), sample.end(), dataset.size());
+
+  learned_hashing::quality::Report report;
+  for (auto _ : state)
+    report =
+        learned_hashing::quality::evaluate(hashfn, dataset, dataset.size());
+
+  state.counters["collisions"] = report.collisions;
+  state.counters["empty_slot_fraction"] = report.empty_slot_fraction;
+  state.counters["max_load"] = report.max_load;
+  state.counters["load_p50"] = report.load_p50;
+  state.counters["load_p90"] = report.load_p90;
+  state.counters["load_p99"] = report.load_p99;
+  state.counters["load_p999"] = report.load_p999;
+  state.counters["linear_probing_expected_probes"] =
+      report.linear_probing_expected_probes;
+  state.counters["chi_square"] = report.chi_square;
+
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["sample_size"] = sample_size;
+  state.counters["hashfn_byte_size"] = hashfn.byte_size();
+  state.counters["hashfn_model_count"] = hashfn.model_count();
+
+  state.SetLabel(Hashfn::name() + ":" + dataset::name(ds_id));
+}
+
+template <class Hashfn>
+static void BM_strings(benchmark::State& state) {
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::StringID>(state.range(1));
+  const double sample_size = static_cast<double>(state.range(2)) / 100.0;
+
+  // generating strings is expensive -> cache across benchmarks
+  static std::map<std::pair<dataset::StringID, size_t>,
+                  std::vector<std::string>>
+      cache;
+  auto& cached = cache[{ds_id, ds_size}];
+  if (cached.empty()) cached = dataset::generate_strings(ds_id, ds_size);
+  auto dataset = cached;
+
+  // shuffle dataset to pick sample uniform randomly
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  const auto sample_n = dataset.size() * sample_size;
+  std::vector<std::string> sample(dataset.begin(), dataset.begin() + sample_n);
+  std::sort(sample.begin(), sample.end());
+
+  const auto build_start_time = std::chrono::steady_clock::now();
+  const Hashfn hashfn(sample.begin(), sample.end(), dataset.size());
+  const auto build_end_time = std::chrono::steady_clock::now();
+
+  // dataset is shuffled, i.e., probing in order is random
+  size_t i = 0;
+  for (auto _ : state) {
+    while (unlikely(i >= dataset.size())) i -= dataset.size();
+    const auto pred_rank = hashfn(dataset[i++]);
+    benchmark::DoNotOptimize(pred_rank);
+
+    // prevent interleaved execution
+    __sync_synchronize();
+  }
+
+  const auto report =
+      learned_hashing::quality::evaluate(hashfn, dataset, dataset.size());
+  state.counters["collisions"] = report.collisions;
+  state.counters["build_time"] =
+      std::chrono::duration<double>(build_end_time - build_start_time).count();
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["sample_size"] = sample_size;
+  state.counters["hashfn_byte_size"] = hashfn.byte_size();
+  state.counters["hashfn_model_count"] = hashfn.model_count();
+
+  state.SetLabel(Hashfn::name() + ":" + dataset::name(ds_id));
+  state.SetItemsProcessed(static_cast<size_t>(state.iterations()));
+}
+
+/// how BM_retraining replaces the model while probing
+enum class RetrainMode {
+  /// never retrain, i.e., VersionedHash's reader overhead only
+  None = 0,
+  /// continuously retrain & publish via VersionedHash
+  Versioned = 1,
+  /// continuously retrain under an exclusive lock, readers take a shared lock
+  Locked = 2
+};
+
+template <class Hashfn>
+static void BM_retraining(benchmark::State& state) {
+  using Key = std::uint64_t;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const auto mode = static_cast<RetrainMode>(state.range(2));
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  // retraining alternates between two distinct 1% samples
+  const size_t sample_n = std::max<size_t>(2, dataset.size() / 100);
+  std::array<std::vector<Key>, 2> samples;
+  for (size_t s = 0; s < samples.size(); s++) {
+    samples[s].assign(dataset.begin() + s * sample_n,
+                      dataset.begin() + (s + 1) * sample_n);
+    std::sort(samples[s].begin(), samples[s].end());
+  }
+
+  learned_hashing::VersionedHash<Hashfn> versioned(
+      samples[0].begin(), samples[0].end(), dataset.size());
+  std::shared_mutex mutex;
+  Hashfn locked(samples[0].begin(), samples[0].end(), dataset.size());
+
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> retrains{0};
+  std::thread retrainer([&] {
+    if (mode == RetrainMode::None) return;
+    for (size_t round = 1; !stop; round++) {
+      const auto& sample = samples[round & 1];
+      if (mode == RetrainMode::Versioned) {
+        versioned.retrain(sample.begin(), sample.end(), dataset.size());
+      } else {
+        std::unique_lock lock(mutex);
+        locked = Hashfn(sample.begin(), sample.end(), dataset.size());
+      }
+      retrains++;
+    }
+  });
+
+  // dataset is shuffled, i.e., probing in order is random
+  auto reader = versioned.reader();
+  size_t i = 0;
+  const auto probe_start_time = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    while (unlikely(i >= dataset.size())) i -= dataset.size();
+    const auto& key = dataset[i++];
+
+    size_t pred_rank;
+    if (mode == RetrainMode::Locked) {
+      std::shared_lock lock(mutex);
+      pred_rank = locked(key);
+    } else {
+      pred_rank = reader(key);
+    }
+    benchmark::DoNotOptimize(pred_rank);
+
+    // prevent interleaved execution
+    __sync_synchronize();
+  }
+  const auto probe_end_time = std::chrono::steady_clock::now();
+  stop = true;
+  retrainer.join();
+
+  state.counters["retrains"] = retrains.load();
+  state.counters["retrains_per_second"] =
+      retrains.load() /
+      std::chrono::duration<double>(probe_end_time - probe_start_time).count();
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["hashfn_byte_size"] = versioned.byte_size();
+
+  const std::array<std::string, 3> mode_names{"none", "versioned", "locked"};
+  state.SetLabel(Hashfn::name() + ":" + dataset::name(ds_id) + ":" +
+                 mode_names[static_cast<size_t>(mode)]);
+  state.SetItemsProcessed(static_cast<size_t>(state.iterations()));
+}
+
+/// mixed insert/hash workloads on dynamic hash functions
+template <class Hashfn>
+static void BM_mixed_insert_hash(benchmark::State& state) {
+  using Key = std::uint64_t;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+  const auto insert_percent = static_cast<size_t>(state.range(2));
+  // 1 inserts keys one by one, larger values buffer & insert batches
+  const auto batch_size = static_cast<size_t>(state.range(3));
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  // bulk load half of the keys, insert the other half
+  std::vector<Key> present(dataset.begin(), dataset.begin() + ds_size / 2);
+  std::vector<Key> sorted = present;
+  std::sort(sorted.begin(), sorted.end());
+  const auto build_start_time = std::chrono::steady_clock::now();
+  Hashfn hashfn(sorted.begin(), sorted.end());
+  const auto build_end_time = std::chrono::steady_clock::now();
+  sorted.clear();
+  present.reserve(dataset.size());
+
+  std::vector<Key> batch;
+  batch.reserve(batch_size);
+  size_t next_insert = present.size();
+  size_t inserts = 0, op = 0;
+  for (auto _ : state) {
+    // deterministic interleaving, e.g., every other operation for 50%
+    if ((op++ * insert_percent) % 100 < insert_percent &&
+        next_insert < dataset.size()) {
+      const auto& key = dataset[next_insert++];
+      inserts++;
+      if (batch_size <= 1) {
+        hashfn.insert(key);
+        present.push_back(key);
+      } else {
+        batch.push_back(key);
+        if (batch.size() == batch_size) {
+          std::sort(batch.begin(), batch.end());
+          hashfn.insert_batch(batch.begin(), batch.end());
+          present.insert(present.end(), batch.begin(), batch.end());
+          batch.clear();
+        }
+      }
+    } else {
+      // present is shuffled, i.e., probing in order is random
+      const auto& key = present[op % present.size()];
+      const auto pred_rank = hashfn(key);
+      benchmark::DoNotOptimize(pred_rank);
+    }
+
+    // prevent interleaved execution
+    __sync_synchronize();
+  }
+
+  state.counters["build_time"] =
+      std::chrono::duration<double>(build_end_time - build_start_time).count();
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["inserts"] = inserts;
+  state.counters["final_size"] = hashfn.size();
+  state.counters["hashfn_byte_size"] = hashfn.byte_size();
+  state.counters["hashfn_model_count"] = hashfn.model_count();
+
+  state.SetLabel(Hashfn::name() + ":" + dataset::name(ds_id) + ":insert" +
+                 std::to_string(insert_percent) + ":batch" +
+                 std::to_string(batch_size));
+  state.SetItemsProcessed(static_cast<size_t>(state.iterations()));
+}
+
+#define BM_MIXED_INSERT_HASH(...)                                             \
+  BENCHMARK_TEMPLATE(BM_mixed_insert_hash, __VA_ARGS__)                       \
+      ->ArgsProduct({{10'000'000, 200'000'000},                               \
+                     {static_cast<std::int64_t>(dataset::ID::UNIFORM),        \
+                      static_cast<std::int64_t>(dataset::ID::NORMAL),         \
+                      static_cast<std::int64_t>(dataset::ID::OSM)},           \
+                     {10, 50},                                                \
+                     {1, 1024}})                                              \
+      ->Iterations(10000000)                                                  \
+      ->Repetitions(3);
+
+/**
+ * Simulates a hash table growing by doubling: starts with 1/64 of the keys
+ * and one slot per key, inserts the remaining keys and doubles the slot count
+ * (rescale() + rehash of all keys) whenever keys exceed slots. Measures the
+ * overall insert time as well as the collisions at the final size
+ */
+template <class Hashfn>
+static void BM_growing_table(benchmark::State& state) {
+  using Key = std::uint64_t;
+  const auto ds_size = state.range(0);
+  const auto ds_id = static_cast<dataset::ID>(state.range(1));
+
+  auto dataset = dataset::load_cached<Key>(ds_id, ds_size);
+  if (dataset.empty()) throw std::runtime_error("benchmark dataset empty");
+
+  std::random_device rd_dev;
+  std::default_random_engine rng(rd_dev());
+  std::shuffle(dataset.begin(), dataset.end(), rng);
+
+  const size_t initial_n = std::max<size_t>(1, dataset.size() / 64);
+  std::vector<Key> initial(dataset.begin(), dataset.begin() + initial_n);
+  std::sort(initial.begin(), initial.end());
+
+  size_t doublings = 0, collisions = 0;
+  double rehash_time = 0;
+  for (auto _ : state) {
+    size_t table_size = initial_n;
+    Hashfn hashfn(initial.begin(), initial.end(), table_size);
+    // some hash functions map to [0, full_size]
+    const auto slot = [&](const Key& key) {
+      return std::min<size_t>(hashfn(key), table_size - 1);
+    };
+    std::vector<std::uint32_t> occupancy(table_size, 0);
+    for (size_t i = 0; i < initial_n; i++) occupancy[slot(dataset[i])]++;
+
+    doublings = 0;
+    rehash_time = 0;
+    for (size_t i = initial_n; i < dataset.size(); i++) {
+      hashfn.insert(dataset[i]);
+      if (i + 1 > table_size) {
+        const auto rehash_start_time = std::chrono::steady_clock::now();
+        table_size *= 2;
+        hashfn.rescale(table_size);
+        occupancy.assign(table_size, 0);
+        for (size_t j = 0; j <= i; j++) occupancy[slot(dataset[j])]++;
+        doublings++;
+        rehash_time += std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() -
+                           rehash_start_time)
+                           .count();
+      } else {
+        occupancy[slot(dataset[i])]++;
+      }
+    }
+
+    size_t occupied = 0;
+    for (const auto& count : occupancy) occupied += count > 0;
+    collisions = dataset.size() - occupied;
+    benchmark::DoNotOptimize(collisions);
+  }
+
+  state.counters["dataset_size"] = dataset.size();
+  state.counters["doublings"] = doublings;
+  state.counters["rehash_time"] = rehash_time;
+  state.counters["collision_rate"] =
+      static_cast<double>(collisions) / dataset.size();
+
+  state.SetLabel(Hashfn::name() + ":" + dataset::name(ds_id));
+  state.SetItemsProcessed(static_cast<size_t>(state.iterations()) *
+                          (dataset.size() - initial_n));
+}
+
+#define BM_GROWING_TABLE(...)                                                 \
+  BENCHMARK_TEMPLATE(BM_growing_table, __VA_ARGS__)                           \
+      ->ArgsProduct({{10'000'000}, datasets})                                 \
+      ->Iterations(1)                                                         \
+      ->Repetitions(3);
+
+#define BM_PARTITIONING(...)                                                  \
+  BENCHMARK_TEMPLATE(BM_partitioning, __VA_ARGS__)                            \
+      ->ArgsProduct({scattering_ds_sizes,                                     \
+                     datasets,                                                \
+                     {64, 1024, 16384},                                       \
+                     {1, static_cast<std::int64_t>(                           \
+                             std::thread::hardware_concurrency())}})          \
+      ->Iterations(3)                                                         \
+      ->UseRealTime();
+
+#define BM_SORTING(...)                                                       \
+  BENCHMARK_TEMPLATE(BM_sorting, __VA_ARGS__)                                 \
+      ->ArgsProduct({{10'000'000, 100'000'000},                               \
+                     datasets,                                                \
+                     {1, static_cast<std::int64_t>(                           \
+                             std::thread::hardware_concurrency())}})          \
+      ->Iterations(1)                                                         \
+      ->Repetitions(3)                                                        \
+      ->UseRealTime();
+
+#define BM_LOWER_BOUND(...)                                                   \
+  BENCHMARK_TEMPLATE(BM_lower_bound, __VA_ARGS__)                             \
       ->ArgsProduct(                                                          \
           {throughput_ds_sizes, datasets, sample_sizes, probe_distributions}) \
+      ->Iterations(10000000)                                                  \
+      ->Repetitions(3);
+
+#define BM_MONOTONE_TABLE(...)                                                \
+  BENCHMARK_TEMPLATE(BM_monotone_table, __VA_ARGS__)                          \
+      ->ArgsProduct({{10'000'000, 200'000'000},                               \
+                     {static_cast<std::int64_t>(dataset::ID::FB),             \
+                      static_cast<std::int64_t>(dataset::ID::OSM),            \
+                      static_cast<std::int64_t>(dataset::ID::WIKI)},          \
+                     {0, 10, 100, 1000}})                                     \
+      ->Iterations(1'000'000)                                                 \
+      ->Repetitions(3);
+
+#define BM_CUCKOO_TABLE(...)                                                  \
+  BENCHMARK_TEMPLATE(BM_cuckoo_table, __VA_ARGS__)                            \
+      ->ArgsProduct({{10'000'000}, datasets, {90, 95, 98}, {0, 1}})           \
+      ->Iterations(10'000)                                                    \
+      ->Repetitions(3);
+
+#define BM_CHAINED_TABLE(...)                                                 \
+  BENCHMARK_TEMPLATE(BM_chained_table, __VA_ARGS__)                           \
+      ->ArgsProduct(                                                          \
+          {{10'000'000}, datasets, {50, 100, 200, 400}, probe_distributions}) \
+      ->Iterations(10'000)                                                    \
+      ->Repetitions(3);
+
+#define BM_STRINGS(...)                                                       \
+  BENCHMARK_TEMPLATE(BM_strings, __VA_ARGS__)                                 \
+      ->ArgsProduct({{1'000'000, 10'000'000},                                 \
+                     {static_cast<std::int64_t>(dataset::StringID::URL),      \
+                      static_cast<std::int64_t>(dataset::StringID::ID)},      \
+                     sample_sizes})                                           \
+      ->Iterations(10000000)                                                  \
+      ->Repetitions(3);
+
+#define BM_RETRAINING(...)                                                    \
+  BENCHMARK_TEMPLATE(BM_retraining, __VA_ARGS__)                              \
+      ->ArgsProduct(                                                          \
+          {{10'000'000},                                                      \
+           {static_cast<std::int64_t>(dataset::ID::UNIFORM),                  \
+            static_cast<std::int64_t>(dataset::ID::NORMAL)},                  \
+           {static_cast<std::int64_t>(RetrainMode::None),                     \
+            static_cast<std::int64_t>(RetrainMode::Versioned),                \
+            static_cast<std::int64_t>(RetrainMode::Locked)}})                 \
+      ->Iterations(10000000)                                                  \
+      ->Repetitions(3)                                                        \
+      ->UseRealTime();
+
+#define BM_KEY(Key, ds_list, ...)                                             \
+  BENCHMARK_TEMPLATE(BM_scattering, __VA_ARGS__, Key)                         \
+      ->ArgsProduct({scattering_ds_sizes, ds_list, sample_sizes})             \
+      ->Iterations(1);                                                        \
+  BENCHMARK_TEMPLATE(BM_quality, __VA_ARGS__, Key)                            \
+      ->ArgsProduct({scattering_ds_sizes, ds_list, sample_sizes})             \
+      ->Iterations(1);                                                        \
+  BENCHMARK_TEMPLATE(BM_build_and_throughput, __VA_ARGS__, Key)               \
+      ->ArgsProduct(                                                          \
+          {throughput_ds_sizes, ds_list, sample_sizes, probe_distributions})  \
       ->Iterations(50000000)                                                  \
       ->Repetitions(3);
+#define BM(...) BM_KEY(std::uint64_t, datasets, __VA_ARGS__)
+#define BM32(...) BM_KEY(std::uint32_t, datasets32, __VA_ARGS__)
+#define BM128(...) BM_KEY(unsigned __int128, datasets, __VA_ARGS__)
 
 #define SINGLE_ARG(...) __VA_ARGS__
 
@@ -184,6 +1264,102 @@ struct DoNothing {
   size_t model_count() const { return 0; }
 };
 
+/// AutoLearnedHash with a fixed byte budget and target metric
+template <class T, size_t ByteBudget,
+          learned_hashing::AutoTuneOptions::Metric Metric =
+              learned_hashing::AutoTuneOptions::Metric::Latency>
+struct AutoLearnedHash : public learned_hashing::AutoLearnedHash<T> {
+  template <class It>
+  AutoLearnedHash(const It& begin, const It& end, const size_t full_size)
+      : learned_hashing::AutoLearnedHash<T>(begin, end, full_size, options()) {
+  }
+
+  static std::string name() {
+    return learned_hashing::AutoLearnedHash<T>::name() + "_budget" +
+           std::to_string(ByteBudget) +
+           (Metric == learned_hashing::AutoTuneOptions::Metric::Latency
+                ? "_latency"
+                : "_collisions");
+  }
+
+ private:
+  static learned_hashing::AutoTuneOptions options() {
+    learned_hashing::AutoTuneOptions options;
+    options.byte_budget = ByteBudget;
+    options.metric = Metric;
+    return options;
+  }
+};
+
+/// ScaledDynamicPGMHash bulk loaded with most of the sample and grown via
+/// single key inserts (every 16th sample key), i.e., hashing combines ranks of
+/// multiple levels
+template <class T, size_t Epsilon>
+struct DynamicPGMHash
+    : public learned_hashing::ScaledDynamicPGMHash<T, Epsilon> {
+  template <class It>
+  DynamicPGMHash(const It& begin, const It& end, const size_t full_size) {
+    std::vector<T> bulk, inserted;
+    for (auto it = begin; it < end; it++)
+      (std::distance(begin, it) % 16 == 15 ? inserted : bulk).push_back(*it);
+    this->train(bulk.begin(), bulk.end(), full_size);
+    for (const auto& key : inserted) this->insert(key);
+    this->rescale(full_size);
+  }
+};
+
+/// murmur hashing, i.e., classical baseline for BM_growing_table,
+/// BM_cuckoo_table and BM_chained_table
+struct GrowingMurmurHash {
+  size_t full_size = 1;
+
+  GrowingMurmurHash() = default;
+
+  template <class It>
+  GrowingMurmurHash(const It&, const It&, const size_t full_size)
+      : full_size(full_size) {}
+
+  void insert(const std::uint64_t&) {}
+  void rescale(const size_t new_full_size) { full_size = new_full_size; }
+
+  forceinline size_t operator()(const std::uint64_t& key) const {
+    return (static_cast<unsigned __int128>(
+                learned_hashing::murmur_finalizer(key)) *
+            full_size) >>
+           64;
+  }
+
+  static std::string name() { return "murmur"; }
+  size_t byte_size() const { return sizeof(*this); }
+};
+
+/// static learned hash function retrained from scratch on all keys whenever
+/// the table grows
+template <class Hashfn>
+struct RetrainOnRescale {
+  Hashfn fn;
+  std::vector<std::uint64_t> keys;
+
+  template <class It>
+  RetrainOnRescale(const It& begin, const It& end, const size_t full_size)
+      : fn(begin, end, full_size), keys(begin, end) {}
+
+  void insert(const std::uint64_t& key) { keys.push_back(key); }
+  void rescale(const size_t new_full_size) {
+    std::sort(keys.begin(), keys.end());
+    fn = Hashfn(keys.begin(), keys.end(), new_full_size);
+  }
+
+  forceinline size_t operator()(const std::uint64_t& key) const {
+    return fn(key);
+  }
+
+  static std::string name() { return "retrained_" + Hashfn::name(); }
+  size_t byte_size() const {
+    return fn.byte_size() + keys.capacity() * sizeof(std::uint64_t);
+  }
+};
+
 using Data = std::uint64_t;
 
 BENCHMARK_TEMPLATE(BM_build_and_throughput, DoNothing<Data>)
@@ -195,6 +1371,26 @@ BENCHMARK_TEMPLATE(BM_build_and_throughput, DoNothing<Data>)
     ->Iterations(50000000)
     ->Repetitions(3);
 
+BENCHMARK_TEMPLATE(BM_build_and_throughput, DoNothing<std::uint32_t>,
+                   std::uint32_t)
+    ->ArgsProduct({throughput_ds_sizes,
+                   {static_cast<std::underlying_type_t<dataset::ID>>(
+                       dataset::ID::SEQUENTIAL)},
+                   {100},
+                   probe_distributions})
+    ->Iterations(50000000)
+    ->Repetitions(3);
+
+BENCHMARK_TEMPLATE(BM_build_and_throughput, DoNothing<unsigned __int128>,
+                   unsigned __int128)
+    ->ArgsProduct({throughput_ds_sizes,
+                   {static_cast<std::underlying_type_t<dataset::ID>>(
+                       dataset::ID::SEQUENTIAL)},
+                   {100},
+                   probe_distributions})
+    ->Iterations(50000000)
+    ->Repetitions(3);
+
 BM(SINGLE_ARG(learned_hashing::RMIHash<std::uint64_t, 1'000'000>));
 BM(SINGLE_ARG(learned_hashing::RMIHash<std::uint64_t, 10'000>));
 BM(SINGLE_ARG(learned_hashing::RMIHash<std::uint64_t, 100>));
@@ -203,6 +1399,9 @@ BM(SINGLE_ARG(learned_hashing::PGMHash<std::uint64_t, 4>));
 BM(SINGLE_ARG(learned_hashing::PGMHash<std::uint64_t, 16>));
 BM(SINGLE_ARG(learned_hashing::PGMHash<std::uint64_t, 128>));
 
+BM(SINGLE_ARG(DynamicPGMHash<std::uint64_t, 16>));
+BM(SINGLE_ARG(DynamicPGMHash<std::uint64_t, 128>));
+
 BM(SINGLE_ARG(learned_hashing::CHTHash<std::uint64_t, 4>));
 BM(SINGLE_ARG(learned_hashing::CHTHash<std::uint64_t, 16>));
 BM(SINGLE_ARG(learned_hashing::CHTHash<std::uint64_t, 128>));
@@ -210,9 +1409,199 @@ BM(SINGLE_ARG(learned_hashing::CHTHash<std::uint64_t, 128>));
 BM(SINGLE_ARG(learned_hashing::RadixSplineHash<std::uint64_t, 18, 4>));
 BM(SINGLE_ARG(learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>));
 BM(SINGLE_ARG(learned_hashing::RadixSplineHash<std::uint64_t, 18, 128>));
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<std::uint64_t, 12, 16>));
+
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 18, 4, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::BTree>));
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 18, 16, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::BTree>));
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 18, 128, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::BTree>));
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 12, 16, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::BTree>));
+
+// original interleaved (x, y) layout as baseline for the layouts above
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 18, 4, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::Interleaved>));
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 18, 16, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::Interleaved>));
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 18, 128, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::Interleaved>));
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 12, 16, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::Interleaved>));
 
 BM(SINGLE_ARG(learned_hashing::TrieSplineHash<std::uint64_t, 4>));
 BM(SINGLE_ARG(learned_hashing::TrieSplineHash<std::uint64_t, 16>));
 BM(SINGLE_ARG(learned_hashing::TrieSplineHash<std::uint64_t, 128>));
 
+// 32 bit keys, i.e., twice the keys per cache line
+BM32(SINGLE_ARG(learned_hashing::RMIHash<std::uint32_t, 1'000'000>));
+BM32(SINGLE_ARG(learned_hashing::RMIHash<std::uint32_t, 10'000>));
+BM32(SINGLE_ARG(learned_hashing::RMIHash<std::uint32_t, 100>));
+BM32(SINGLE_ARG(learned_hashing::PGMHash<std::uint32_t, 16>));
+BM32(SINGLE_ARG(learned_hashing::CHTHash<std::uint32_t, 16>));
+BM32(SINGLE_ARG(learned_hashing::RadixSplineHash<std::uint32_t, 18, 16>));
+BM32(SINGLE_ARG(learned_hashing::RadixSplineHash<
+                std::uint32_t, 18, 16, std::numeric_limits<size_t>::max(),
+                learned_hashing::_rs::SplineLayout::BTree>));
+BM32(SINGLE_ARG(learned_hashing::TrieSplineHash<std::uint32_t, 16>));
+
+// 128 bit keys (e.g., uuids, composite keys) on widened 64 bit datasets, i.e.,
+// same cdf but wide key arithmetic and half the keys per cache line
+BM128(SINGLE_ARG(learned_hashing::RMIHash<unsigned __int128, 1'000'000>));
+BM128(SINGLE_ARG(learned_hashing::RMIHash<unsigned __int128, 10'000>));
+BM128(SINGLE_ARG(learned_hashing::RMIHash<unsigned __int128, 100>));
+BM128(SINGLE_ARG(learned_hashing::MonotoneRMIHash<unsigned __int128, 10'000>));
+BM128(SINGLE_ARG(learned_hashing::RadixSplineHash<unsigned __int128, 18, 16>));
+BM128(SINGLE_ARG(learned_hashing::RadixSplineHash<
+                 unsigned __int128, 18, 16, std::numeric_limits<size_t>::max(),
+                 learned_hashing::_rs::SplineLayout::BTree>));
+
+// string keys (std::hash as classical baseline)
+struct StdStringHash {
+  size_t full_size;
+
+  template <class It>
+  StdStringHash(const It&, const It&, const size_t full_size)
+      : full_size(full_size) {}
+
+  forceinline size_t operator()(const std::string_view& key) const {
+    const std::uint64_t h = std::hash<std::string_view>{}(key);
+    return (static_cast<unsigned __int128>(h) * full_size) >> 64;
+  }
+
+  static std::string name() { return "std_hash"; }
+  size_t byte_size() const { return 0; }
+  size_t model_count() const { return 0; }
+};
+BM_STRINGS(StdStringHash);
+BM_STRINGS(SINGLE_ARG(learned_hashing::StringLearnedHash<
+                      learned_hashing::RMIHash<std::uint64_t, 10'000>>));
+BM_STRINGS(SINGLE_ARG(
+    learned_hashing::StringLearnedHash<
+        learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>));
+BM_STRINGS(SINGLE_ARG(learned_hashing::StringLearnedHash<
+                      learned_hashing::PGMHash<std::uint64_t, 16>>));
+
+// automatically selected configurations, e.g., with L2 & LLC sized budgets
+BM(SINGLE_ARG(AutoLearnedHash<Data, 1024 * 1024>));
+BM(SINGLE_ARG(AutoLearnedHash<Data, 32 * 1024 * 1024>));
+BM(SINGLE_ARG(
+    AutoLearnedHash<Data, 32 * 1024 * 1024,
+                    learned_hashing::AutoTuneOptions::Metric::Collisions>));
+
+// learned models with classical fallback for poorly modelled regions
+BM(SINGLE_ARG(learned_hashing::HybridHash<
+              Data, learned_hashing::RMIHash<std::uint64_t, 10'000>>));
+BM(SINGLE_ARG(learned_hashing::HybridHash<
+              Data, learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>));
+
+// drift monitoring overhead (compare with unmonitored variants above). Note
+// that exponential probing is skewed, i.e., reported as drift
+BM(SINGLE_ARG(learned_hashing::MonitoredHash<
+              learned_hashing::RMIHash<std::uint64_t, 10'000>>));
+BM(SINGLE_ARG(learned_hashing::MonitoredHash<
+              learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>));
+BM(SINGLE_ARG(learned_hashing::MonitoredHash<
+              learned_hashing::RMIHash<std::uint64_t, 10'000>, 8, 0>));
+
+// dynamic hash functions under mixed insert/hash workloads
+BM_MIXED_INSERT_HASH(
+    SINGLE_ARG(learned_hashing::DynamicPGMHash<std::uint64_t, 16>));
+BM_MIXED_INSERT_HASH(
+    SINGLE_ARG(learned_hashing::DynamicPGMHash<std::uint64_t, 128>));
+
+// learned vs. radix partitioning, e.g., for partitioned joins
+BM_PARTITIONING(RadixPartitioning);
+BM_PARTITIONING(SINGLE_ARG(learned_hashing::RMIHash<std::uint64_t, 10'000>));
+BM_PARTITIONING(
+    SINGLE_ARG(learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>));
+
+// learned sort vs. comparison & radix sort
+BM_SORTING(StdSort);
+BM_SORTING(RadixSort);
+BM_SORTING(
+    SINGLE_ARG(LearnedSort<learned_hashing::RadixSplineHash<Data, 18, 16>>));
+BM_SORTING(
+    SINGLE_ARG(LearnedSort<learned_hashing::TrieSplineHash<Data, 16>>));
+BM_SORTING(SINGLE_ARG(LearnedSort<learned_hashing::RMIHash<Data, 10'000>>));
+
+// learned index lookups (one model as hash function & index)
+BM_LOWER_BOUND(StdLowerBound);
+BM_LOWER_BOUND(SINGLE_ARG(learned_hashing::SearchableHash<
+                          learned_hashing::RMIHash<std::uint64_t, 10'000>>));
+BM_LOWER_BOUND(SINGLE_ARG(
+    RMIBoundsSearch<learned_hashing::RMIHash<std::uint64_t, 10'000>>));
+BM_LOWER_BOUND(SINGLE_ARG(
+    RMIBoundsSearch<learned_hashing::RMIHash<std::uint64_t, 1'000'000>>));
+BM_LOWER_BOUND(SINGLE_ARG(learned_hashing::SearchableHash<
+                          learned_hashing::PGMHash<std::uint64_t, 16>>));
+BM_LOWER_BOUND(SINGLE_ARG(learned_hashing::SearchableHash<
+                          learned_hashing::CHTHash<std::uint64_t, 16>>));
+BM_LOWER_BOUND(SINGLE_ARG(
+    learned_hashing::SearchableHash<
+        learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>));
+BM_LOWER_BOUND(SINGLE_ARG(learned_hashing::SearchableHash<
+                          learned_hashing::TrieSplineHash<std::uint64_t, 16>>));
+
+// ordered point & range queries, monotone hash tables vs. b-tree
+BM_MONOTONE_TABLE(BTreeTable);
+BM_MONOTONE_TABLE(SINGLE_ARG(
+    MonotoneTable<learned_hashing::MonotoneRMIHash<std::uint64_t, 10'000>>));
+BM_MONOTONE_TABLE(
+    SINGLE_ARG(MonotoneTable<learned_hashing::CHTHash<std::uint64_t, 16>>));
+BM_MONOTONE_TABLE(SINGLE_ARG(
+    MonotoneTable<learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>));
+
+// bucketized cuckoo tables, learned vs. classical primary hash (the
+// alternate hash is always murmur)
+BM_CUCKOO_TABLE(GrowingMurmurHash);
+BM_CUCKOO_TABLE(SINGLE_ARG(learned_hashing::RMIHash<std::uint64_t, 10'000>));
+BM_CUCKOO_TABLE(
+    SINGLE_ARG(learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>));
+
+// chained tables, arena allocated chains vs. std::vector per bucket
+BM_CHAINED_TABLE(SINGLE_ARG(
+    VectorChainedTable<learned_hashing::RMIHash<std::uint64_t, 10'000>>));
+BM_CHAINED_TABLE(ChainedTable<GrowingMurmurHash>);
+BM_CHAINED_TABLE(
+    SINGLE_ARG(ChainedTable<learned_hashing::RMIHash<std::uint64_t, 10'000>>));
+BM_CHAINED_TABLE(SINGLE_ARG(
+    ChainedTable<learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>));
+
+// hash tables growing by doubling
+BM_GROWING_TABLE(GrowingMurmurHash);
+BM_GROWING_TABLE(
+    SINGLE_ARG(learned_hashing::ScaledDynamicPGMHash<std::uint64_t, 16>));
+BM_GROWING_TABLE(SINGLE_ARG(
+    RetrainOnRescale<learned_hashing::PGMHash<std::uint64_t, 16>>));
+BM_GROWING_TABLE(SINGLE_ARG(
+    RetrainOnRescale<learned_hashing::RMIHash<std::uint64_t, 10'000>>));
+
+// lookups during continuous retraining (rcu style publishing vs. locking)
+BM_RETRAINING(SINGLE_ARG(learned_hashing::RMIHash<std::uint64_t, 10'000>));
+BM_RETRAINING(
+    SINGLE_ARG(learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>));
+
+// large models backed by huge pages (compare with default allocator variants
+// above, especially at 200M keys)
+using HugePages = learned_hashing::HugePageAllocator<Data>;
+BM(SINGLE_ARG(learned_hashing::RMIHash<
+              std::uint64_t, 1'000'000, 2, double,
+              learned_hashing::LinearImpl<std::uint64_t, double>,
+              learned_hashing::LinearImpl<std::uint64_t, double>, HugePages>));
+BM(SINGLE_ARG(learned_hashing::CHTHash<std::uint64_t, 4, 64, HugePages>));
+BM(SINGLE_ARG(learned_hashing::RadixSplineHash<
+              std::uint64_t, 18, 4, std::numeric_limits<size_t>::max(),
+              learned_hashing::_rs::SplineLayout::Sorted, HugePages>));
+BM(SINGLE_ARG(learned_hashing::TrieSplineHash<std::uint64_t, 4, HugePages>));
+
 BENCHMARK_MAIN();
@@ -1,100 +1,292 @@
 #include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <cstdint>
-#include <fstream>
-#include <iomanip>
-#include <ios>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
-#include <iterator>
 #include <learned_hashing.hpp>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "include/rmi.hpp"
+#include "support/columnar.hpp"
 #include "support/datasets.hpp"
 
+/**
+ * Runs fn(thread_id, begin, end) on thread_count equally sized chunks of
+ * [0, n) in parallel
+ */
+template <class Fn>
+void parallel_for(size_t n, size_t thread_count, const Fn& fn) {
+  thread_count = std::max<size_t>(1, std::min(thread_count, n));
+  if (thread_count == 1) return fn(0, 0, n);
+
+  std::vector<std::thread> threads;
+  const size_t chunk = (n + thread_count - 1) / thread_count;
+  for (size_t t = 0; t < thread_count; t++)
+    threads.emplace_back(fn, t, std::min(n, t * chunk),
+                         std::min(n, (t + 1) * chunk));
+  for (auto& thread : threads) thread.join();
+}
+
+/// thread safe progress output
+void log_writing(const std::string& filepath) {
+  static std::mutex mutex;
+  std::unique_lock<std::mutex> lock(mutex);
+  std::cout << "writing: " << filepath << '\n' << std::flush;
+}
+
 /**
  * Builds a distribution histogram over the entire dataset given a certain
  * hashfunction, dataset and bucket size
  *
  * bucket_size \in [0, 1]
  */
-template <class Hashfn, class RandomIt>
+template <class Hashfn, class Data>
 void histogram(const Hashfn& fn, const std::string& filepath,
-               const RandomIt& begin, const RandomIt& end, double bucket_cnt) {
-  // variables
-  std::vector<size_t> hist(bucket_cnt, 0);
+               const std::vector<Data>& dataset, size_t bucket_cnt,
+               size_t thread_count) {
+  if (bucket_cnt == 0) return;
 
-  // build historgram
-  for (auto it = begin; it < end; it++) hist[fn(*it)]++;
+  // build per thread histograms to avoid contention, merge afterwards
+  std::vector<std::vector<std::uint64_t>> partials(
+      std::max<size_t>(1, std::min(thread_count, dataset.size())));
+  parallel_for(dataset.size(), thread_count,
+               [&](size_t t, const size_t begin, const size_t end) {
+                 auto& hist = partials[t];
+                 hist.resize(bucket_cnt, 0);
+                 for (size_t i = begin; i < end; i++) hist[fn(dataset[i])]++;
+               });
 
-  if (hist.empty()) return;
+  std::vector<std::uint64_t> hist(bucket_cnt, 0);
+  for (const auto& partial : partials)
+    for (size_t i = 0; i < partial.size(); i++) hist[i] += partial[i];
 
-  std::ofstream csv_file;
-  csv_file.open(filepath);
-  std::cout << "writing: " << filepath << std::endl;
+  std::vector<double> lower(bucket_cnt), upper(bucket_cnt);
+  for (size_t i = 0; i < bucket_cnt; i++) {
+    lower[i] = static_cast<double>(i) / static_cast<double>(bucket_cnt);
+    upper[i] = static_cast<double>(i + 1) / static_cast<double>(bucket_cnt);
+  }
 
-  csv_file << "bucket_lower,bucket_upper,bucket_value" << std::endl;
-  for (size_t i = 0; i < hist.size(); i++)
-    csv_file << static_cast<double>(i) / static_cast<double>(hist.size()) << ","
-             << static_cast<double>(i + 1) / static_cast<double>(hist.size())
-             << "," << hist[i] << std::endl;
+  columnar::Table table;
+  table.add("bucket_lower", std::move(lower));
+  table.add("bucket_upper", std::move(upper));
+  table.add("bucket_value", std::move(hist));
 
-  csv_file.close();
+  log_writing(filepath);
+  table.write(filepath);
 }
 
-template <class Hashfn, class RandomIt>
-void model(const Hashfn& fn, const std::string& filepath, const RandomIt& begin,
-           const RandomIt& end) {
-  std::ofstream csv_file;
-  csv_file.open(filepath);
-  std::cout << "writing: " << filepath << std::endl;
+/**
+ * Exports (key, hash) for every (dataset.size() / 1M)-th key, i.e., for
+ * roughly 1M keys on large datasets and every key on datasets below 2M keys
+ */
+template <class Hashfn, class Data>
+void model(const Hashfn& fn, const std::string& filepath,
+           const std::vector<Data>& dataset, size_t thread_count) {
+  const size_t step = std::max<size_t>(1, dataset.size() / 1000000);
+  const size_t point_cnt = (dataset.size() + step - 1) / step;
+
+  std::vector<std::uint64_t> x(point_cnt), y(point_cnt);
+  parallel_for(point_cnt, thread_count,
+               [&](size_t, const size_t begin, const size_t end) {
+                 for (size_t i = begin; i < end; i++) {
+                   x[i] = dataset[i * step];
+                   y[i] = fn(dataset[i * step]);
+                 }
+               });
 
-  const auto ds_size = std::distance(begin, end);
+  columnar::Table table;
+  table.add("x", std::move(x));
+  table.add("y", std::move(y));
 
-  csv_file << "x,y" << std::endl;
-  for (auto it = begin; it < end; it += ds_size / 1000000) {
-    csv_file << *it << "," << fn(*it) << std::endl;
+  log_writing(filepath);
+  table.write(filepath);
+}
+
+/**
+ * Exports how evenly an rmi's root model distributes the dataset across its
+ * second level models, i.e., the variance of the models' bucket occupancy.
+ * Lower variance means more even bucket fill
+ */
+template <class Hashfn, class Data>
+void occupancy(const Hashfn& fn, const std::string& filepath,
+               const std::vector<Data>& dataset, size_t thread_count) {
+  const size_t model_cnt = fn.model_count() - 1;
+  if (model_cnt == 0) return;
+
+  std::vector<std::vector<size_t>> partials(
+      std::max<size_t>(1, std::min(thread_count, dataset.size())));
+  parallel_for(dataset.size(), thread_count,
+               [&](size_t t, const size_t begin, const size_t end) {
+                 auto& occ = partials[t];
+                 occ.resize(model_cnt, 0);
+                 // MonotoneRMIHash assigns keys beyond its last model to
+                 // model_cnt, i.e., these count for the last model
+                 for (size_t i = begin; i < end; i++)
+                   occ[std::min(fn.second_level_index(dataset[i]),
+                                model_cnt - 1)]++;
+               });
+
+  std::vector<size_t> occ(model_cnt, 0);
+  for (const auto& partial : partials)
+    for (size_t i = 0; i < partial.size(); i++) occ[i] += partial[i];
+
+  const double mean =
+      static_cast<double>(dataset.size()) / static_cast<double>(model_cnt);
+  double variance = 0.0;
+  size_t empty_cnt = 0, max_occ = 0;
+  for (const auto& o : occ) {
+    variance += (o - mean) * (o - mean);
+    empty_cnt += o == 0;
+    max_occ = std::max(max_occ, o);
   }
+  variance /= static_cast<double>(model_cnt);
+
+  columnar::Table table;
+  table.add<std::uint64_t>("model_cnt", {model_cnt});
+  table.add<std::uint64_t>("empty_model_cnt", {empty_cnt});
+  table.add<double>("mean", {mean});
+  table.add<double>("variance", {variance});
+  table.add<std::uint64_t>("max", {max_occ});
 
-  csv_file.close();
+  log_writing(filepath);
+  table.write(filepath);
 }
 
+/**
+ * Exports collision behaviour metrics when using the hash function to
+ * index a hash table with table_size slots
+ */
+template <class Hashfn, class Data>
+void quality(const Hashfn& fn, const std::string& filepath,
+             const std::vector<Data>& dataset, const size_t table_size,
+             size_t thread_count) {
+  const auto report = learned_hashing::quality::evaluate(
+      fn, dataset, table_size, thread_count);
+
+  columnar::Table table;
+  table.add<std::uint64_t>("key_count", {report.key_count});
+  table.add<std::uint64_t>("table_size", {report.table_size});
+  table.add<std::uint64_t>("collisions", {report.collisions});
+  table.add<double>("empty_slot_fraction", {report.empty_slot_fraction});
+  table.add<std::uint64_t>("max_load", {report.max_load});
+  table.add<std::uint64_t>("load_p50", {report.load_p50});
+  table.add<std::uint64_t>("load_p90", {report.load_p90});
+  table.add<std::uint64_t>("load_p99", {report.load_p99});
+  table.add<std::uint64_t>("load_p999", {report.load_p999});
+  table.add<double>("linear_probing_expected_probes",
+                    {report.linear_probing_expected_probes});
+  table.add<double>("chi_square", {report.chi_square});
+
+  log_writing(filepath);
+  table.write(filepath);
+}
+
+using Data = std::uint64_t;
+
+/// export of a single (hash function, dataset) combination, parameterized
+/// with the amount of threads it may use
+using Task = std::function<void(size_t)>;
+
+/**
+ * Adds the exports of HashFn on dataset to tasks. Collision behaviour is
+ * evaluated on a table with one slot per key, i.e., each evaluation holds a
+ * dataset sized load vector. These go to quality_tasks to be run one at a
+ * time, each with all threads, to bound memory
+ */
 template <class HashFn>
-void export_all_ds(size_t dataset_size, double bucket_step = 0.000001) {
-  for (const auto did :
-       {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10, dataset::ID::UNIFORM,
-        dataset::ID::WIKI, dataset::ID::NORMAL, dataset::ID::OSM,
-        dataset::ID::FB}) {
-    const auto dataset = dataset::load_cached(did, dataset_size);
-    if (dataset.empty()) continue;
-
-    // preconditions
-    std::is_sorted(dataset.begin(), dataset.end());
-    const auto hist_bucket_cnt = 1.0 / bucket_step;
+void export_all(std::vector<Task>& tasks, std::vector<Task>& quality_tasks,
+                const dataset::ID did, const std::vector<Data>& dataset,
+                size_t dataset_size, double bucket_step = 0.000001) {
+  // preconditions
+  assert(std::is_sorted(dataset.begin(), dataset.end()));
+
+  const std::string prefix =
+      "stats/" + std::to_string(dataset_size / 1000000) + "M/";
+  const std::string suffix = HashFn::name() + "_" + dataset::name(did);
+
+  tasks.push_back([&, prefix, suffix, bucket_step](const size_t thread_count) {
+    const size_t hist_bucket_cnt = 1.0 / bucket_step;
 
     // train hash function
     HashFn fn(dataset.begin(), dataset.end(), hist_bucket_cnt);
 
     // export histogram and fn itself
-    histogram(fn,
-              "stats/" + std::to_string(dataset_size / 1000000) +
-                  "M/histogram/" + HashFn::name() + "_" + dataset::name(did) +
-                  ".csv",
-              dataset.begin(), dataset.end(), hist_bucket_cnt);
-    model(fn,
-          "stats/" + std::to_string(dataset_size / 1000000) + "M/models/" +
-              HashFn::name() + "_" + dataset::name(did) + ".csv",
-          dataset.begin(), dataset.end());
-  }
+    histogram(fn, prefix + "histogram/" + suffix, dataset, hist_bucket_cnt,
+              thread_count);
+    model(fn, prefix + "models/" + suffix, dataset, thread_count);
+
+    // bucket occupancy is only defined for two level models
+    if constexpr (requires(const HashFn& f) {
+                    f.second_level_index(dataset.front());
+                  }) {
+      occupancy(fn, prefix + "occupancy/" + suffix, dataset, thread_count);
+    }
+  });
+
+  // collision behaviour when indexing a table with one slot per key
+  quality_tasks.push_back([&, prefix, suffix](const size_t thread_count) {
+    const HashFn table_fn(dataset.begin(), dataset.end(), dataset.size());
+    quality(table_fn, prefix + "quality/" + suffix, dataset, dataset.size(),
+            thread_count);
+  });
+}
+
+/**
+ * Runs all tasks, distributing thread_count threads across concurrently
+ * executed tasks and the per key work within each task
+ */
+void run(const std::vector<Task>& tasks, const size_t thread_count) {
+  const size_t worker_cnt = std::max<size_t>(
+      1, std::min(thread_count, tasks.size()));
+  const size_t threads_per_task =
+      std::max<size_t>(1, thread_count / worker_cnt);
+
+  std::atomic<size_t> next_task = 0;
+  parallel_for(worker_cnt, worker_cnt, [&](size_t, size_t, size_t) {
+    for (size_t i; (i = next_task.fetch_add(1)) < tasks.size();)
+      tasks[i](threads_per_task);
+  });
 }
 
 int main() {
   using RMI = learned_hashing::RMIHash<std::uint64_t, 1000000>;
+  using RadixRMI = learned_hashing::RMIHash<
+      std::uint64_t, 1000000, 2, double,
+      learned_hashing::RadixImpl<std::uint64_t, double>>;
+  using SplineRMI = learned_hashing::RMIHash<
+      std::uint64_t, 1000000, 2, double,
+      learned_hashing::LinearSplineImpl<std::uint64_t, double>>;
   using MonotoneRMI = learned_hashing::MonotoneRMIHash<std::uint64_t, 1000000>;
 
+  // LH_STATS_THREADS overrides the amount of threads
+  size_t thread_count = std::max(1U, std::thread::hardware_concurrency());
+  if (const char* env = std::getenv("LH_STATS_THREADS"); env != nullptr)
+    thread_count = std::max(1UL, std::stoul(env));
+
   for (auto dataset_size : {10000000, 100000000}) {
-    export_all_ds<RMI>(dataset_size);
-    export_all_ds<MonotoneRMI>(dataset_size);
+    // one dataset at a time, i.e., only one copy of a dataset (besides
+    // dataset::load_cached's cache) and its exports' buffers are held at once
+    for (const auto did :
+         {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10, dataset::ID::UNIFORM,
+          dataset::ID::WIKI, dataset::ID::NORMAL, dataset::ID::OSM,
+          dataset::ID::FB}) {
+      const auto dataset = dataset::load_cached(did, dataset_size);
+      if (dataset.empty()) continue;
+
+      std::vector<Task> tasks, quality_tasks;
+      export_all<RMI>(tasks, quality_tasks, did, dataset, dataset_size);
+      export_all<RadixRMI>(tasks, quality_tasks, did, dataset, dataset_size);
+      export_all<SplineRMI>(tasks, quality_tasks, did, dataset, dataset_size);
+      export_all<MonotoneRMI>(tasks, quality_tasks, did, dataset, dataset_size);
+      run(tasks, thread_count);
+      for (const auto& task : quality_tasks) task(thread_count);
+    }
   }
 
   return 0;
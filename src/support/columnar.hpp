@@ -0,0 +1,99 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace columnar {
+/**
+ * Column oriented table that is exported both as human readable csv and as
+ * compact binary file. The latter can be loaded without parsing text (see
+ * read_columnar() in plot_stats.py) and has the following layout, all
+ * integers being little endian:
+ *
+ *   magic       8 bytes, "LHCOLS01"
+ *   row_cnt     u64
+ *   column_cnt  u64
+ *   per column: u64 name length, name, u8 type ('u': u64, 'f': f64)
+ *   per column: row_cnt values of the column's type
+ */
+struct Table {
+  using Column = std::variant<std::vector<std::uint64_t>, std::vector<double>>;
+
+  std::vector<std::pair<std::string, Column>> columns;
+
+  template <class T>
+  void add(const std::string& name, std::vector<T> values) {
+    if (!columns.empty() && row_count(columns.front().second) != values.size())
+      throw std::runtime_error("column " + name + " has mismatching length");
+    columns.emplace_back(name, std::move(values));
+  }
+
+  size_t rows() const {
+    return columns.empty() ? 0 : row_count(columns.front().second);
+  }
+
+  /// writes basepath.csv and basepath.bin, creating parent directories
+  void write(const std::string& basepath) const {
+    std::filesystem::create_directories(
+        std::filesystem::path(basepath).parent_path());
+    write_csv(basepath + ".csv");
+    write_binary(basepath + ".bin");
+  }
+
+  void write_csv(const std::string& filepath) const {
+    std::ofstream file(filepath);
+
+    for (size_t c = 0; c < columns.size(); c++)
+      file << (c > 0 ? "," : "") << columns[c].first;
+    file << '\n';
+
+    for (size_t r = 0; r < rows(); r++) {
+      for (size_t c = 0; c < columns.size(); c++) {
+        if (c > 0) file << ',';
+        std::visit([&](const auto& values) { file << values[r]; },
+                   columns[c].second);
+      }
+      file << '\n';
+    }
+  }
+
+  void write_binary(const std::string& filepath) const {
+    static_assert(std::endian::native == std::endian::little,
+                  "binary format is little endian");
+    std::ofstream file(filepath, std::ios::binary);
+
+    const auto write_u64 = [&](const std::uint64_t v) {
+      file.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    };
+
+    file.write("LHCOLS01", 8);
+    write_u64(rows());
+    write_u64(columns.size());
+    for (const auto& [name, column] : columns) {
+      write_u64(name.size());
+      file.write(name.data(), name.size());
+      file.put(std::holds_alternative<std::vector<double>>(column) ? 'f' : 'u');
+    }
+    for (const auto& column : columns)
+      std::visit(
+          [&](const auto& values) {
+            file.write(reinterpret_cast<const char*>(values.data()),
+                       values.size() * sizeof(values[0]));
+          },
+          column.second);
+  }
+
+ private:
+  static size_t row_count(const Column& column) {
+    return std::visit([](const auto& values) { return values.size(); },
+                      column);
+  }
+};
+}  // namespace columnar
@@ -2,9 +2,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <stdexcept>
 #include <string>
@@ -57,7 +59,7 @@ std::vector<Key> load(const std::string& filepath) {
   }
 
   const auto max_num_elements = (size - sizeof(std::uint64_t)) / sizeof(Key);
-  std::vector<uint64_t> dataset(max_num_elements, 0);
+  std::vector<Key> dataset(max_num_elements, 0);
   {
     std::vector<unsigned char> buffer(size);
     if (!input.read(reinterpret_cast<char*>(buffer.data()), size))
@@ -66,6 +68,7 @@ std::vector<Key> load(const std::string& filepath) {
     // Parse file
     uint64_t num_elements = read_little_endian_8(buffer, 0);
     assert(num_elements <= max_num_elements);
+    dataset.resize(num_elements);
     switch (sizeof(Key)) {
       case sizeof(std::uint64_t):
         for (uint64_t i = 0; i < num_elements; i++) {
@@ -128,6 +131,7 @@ inline std::string name(ID id) {
 };
 
 template <class Data = std::uint64_t>
+  requires(std::numeric_limits<Data>::digits <= 64)
 std::vector<Data> load_cached(ID id, size_t dataset_size) {
   static std::mt19937_64 rng(1337);
 
@@ -145,6 +149,9 @@ std::vector<Data> load_cached(ID id, size_t dataset_size) {
     if (ds_it != id_it->second.end()) return ds_it->second;
   }
 
+  // sosd provides dataset files per key width, e.g., books_200M_uint32
+  const std::string key_bits = std::to_string(sizeof(Data) * 8);
+
   // generate (or random sample) in appropriate size
   std::vector<Data> ds;
   ds.reserve(dataset_size);
@@ -163,7 +170,9 @@ std::vector<Data> load_cached(ID id, size_t dataset_size) {
       break;
     }
     case ID::UNIFORM: {
-      std::uniform_int_distribution<Data> dist(0, (0x1LLU << 50) - 1);
+      std::uniform_int_distribution<Data> dist(
+          0, std::min<std::uint64_t>((0x1LLU << 50) - 1,
+                                     std::numeric_limits<Data>::max()));
       for (size_t i = 0; i < dataset_size; i++) ds.push_back(dist(rng));
       break;
     }
@@ -179,9 +188,9 @@ std::vector<Data> load_cached(ID id, size_t dataset_size) {
         assert(rand_val >= mean - 3 * std_dev);
         assert(rand_val <= mean + 3 * std_dev);
 
-        // rescale to [0, 2^50)
-        const auto rescaled =
-            (rand_val - (mean - 3 * std_dev)) * std::pow(2, 50);
+        // rescale to [0, 2^50), or [0, 2^25) for narrow keys
+        const auto rescaled = (rand_val - (mean - 3 * std_dev)) *
+                              std::pow(2, sizeof(Data) < 8 ? 25 : 50);
 
         // round
         ds.push_back(std::floor(rescaled));
@@ -190,7 +199,7 @@ std::vector<Data> load_cached(ID id, size_t dataset_size) {
     }
     case ID::FB: {
       if (ds_fb.empty()) {
-        ds_fb = load<Data>("data/fb_200M_uint64");
+        ds_fb = load<Data>("data/fb_200M_uint" + key_bits);
         std::shuffle(ds_fb.begin(), ds_fb.end(), rng);
       }
       // ds file does not exist
@@ -203,7 +212,7 @@ std::vector<Data> load_cached(ID id, size_t dataset_size) {
     }
     case ID::OSM: {
       if (ds_osm.empty()) {
-        ds_osm = load<Data>("data/osm_cellids_200M_uint64");
+        ds_osm = load<Data>("data/osm_cellids_200M_uint" + key_bits);
         std::shuffle(ds_osm.begin(), ds_osm.end(), rng);
       }
       // ds file does not exist
@@ -216,7 +225,7 @@ std::vector<Data> load_cached(ID id, size_t dataset_size) {
     }
     case ID::WIKI: {
       if (ds_wiki.empty()) {
-        ds_wiki = load<Data>("data/wiki_ts_200M_uint64");
+        ds_wiki = load<Data>("data/wiki_ts_200M_uint" + key_bits);
         std::shuffle(ds_wiki.begin(), ds_wiki.end(), rng);
       }
       // ds file does not exist
@@ -229,7 +238,7 @@ std::vector<Data> load_cached(ID id, size_t dataset_size) {
     }
     case ID::BOOKS: {
       if (ds_books.empty()) {
-        ds_books = load<Data>("data/books_200M_uint64");
+        ds_books = load<Data>("data/books_200M_uint" + key_bits);
         std::shuffle(ds_books.begin(), ds_books.end(), rng);
       }
       // ds file does not exist
@@ -267,4 +276,94 @@ std::vector<Data> load_cached(ID id, size_t dataset_size) {
 
   return ds;
 }
+
+/**
+ * Datasets for keys wider than 64 bits (e.g., unsigned __int128) resemble
+ * composite (tenant, id) keys: the 64 bit dataset forms the upper half, the
+ * lower half is a multiplicative hash of it. Each key's upper half is unique,
+ * i.e., keys are in the same order and the cdf has the same shape as the 64
+ * bit dataset, while models have to resolve the full key width
+ */
+template <class Data>
+  requires(std::numeric_limits<Data>::digits > 64)
+std::vector<Data> load_cached(ID id, size_t dataset_size) {
+  static std::unordered_map<ID, std::unordered_map<size_t, std::vector<Data>>>
+      datasets;
+
+  auto& ds = datasets[id][dataset_size];
+  if (ds.empty()) {
+    const auto narrow = load_cached<std::uint64_t>(id, dataset_size);
+    ds.reserve(narrow.size());
+    for (const auto key : narrow)
+      ds.push_back((static_cast<Data>(key) << 64) |
+                   static_cast<std::uint64_t>(key * 0x9E3779B97F4A7C15ULL));
+  }
+  return ds;
+}
+
+/// synthetic string datasets
+enum class StringID {
+  /// urls sharing a scheme and few hosts, i.e., long common prefixes
+  URL = 0,
+  /// fixed length, zero padded numeric identifiers, e.g., "user:000123456789"
+  ID = 1
+};
+
+inline std::string name(StringID id) {
+  switch (id) {
+    case StringID::URL:
+      return "url";
+    case StringID::ID:
+      return "id";
+  }
+  return "unnamed";
+};
+
+/**
+ * Generates dataset_size distinct string keys
+ * @return a sorted and deduplicated list of generated strings
+ */
+inline std::vector<std::string> generate_strings(StringID id,
+                                                 size_t dataset_size) {
+  std::mt19937_64 rng(1337);
+
+  const std::vector<std::string> hosts{
+      "docs.python.org",      "en.wikipedia.org",  "github.com",
+      "news.ycombinator.com", "stackoverflow.com", "www.example.com",
+      "www.example.org",      "www.youtube.com"};
+  const std::vector<std::string> words{
+      "about", "api",    "blog",    "docs",  "edit",   "en",     "faq",
+      "files", "help",   "history", "index", "issues", "latest", "news",
+      "page",  "posts",  "pull",    "raw",   "search", "static", "tags",
+      "talk",  "tree",   "user",    "users", "v1",     "v2",     "wiki"};
+  std::uniform_int_distribution<size_t> host_dist(0, hosts.size() - 1);
+  std::uniform_int_distribution<size_t> word_dist(0, words.size() - 1);
+  std::uniform_int_distribution<size_t> depth_dist(1, 3);
+  std::uniform_int_distribution<std::uint64_t> num_dist(0, 999'999'999'999);
+
+  std::vector<std::string> ds;
+  ds.reserve(dataset_size);
+
+  // regenerate duplicates until dataset_size distinct keys exist
+  while (ds.size() < dataset_size) {
+    for (size_t i = ds.size(); i < dataset_size; i++) {
+      const auto num = std::to_string(num_dist(rng));
+      switch (id) {
+        case StringID::URL: {
+          std::string url = "https://" + hosts[host_dist(rng)];
+          for (size_t d = depth_dist(rng); d > 0; d--)
+            url += "/" + words[word_dist(rng)];
+          ds.push_back(url + "/" + num);
+          break;
+        }
+        case StringID::ID:
+          ds.push_back("user:" + std::string(12 - num.size(), '0') + num);
+          break;
+      }
+    }
+    deduplicate_and_sort(ds);
+  }
+
+  return ds;
+}
 };  // namespace dataset
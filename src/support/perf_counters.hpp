@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf {
+/**
+ * Hardware performance counters (cycles, instructions, L1d/LLC/dTLB load
+ * misses, branch mispredicts) of the calling thread via perf_event_open.
+ *
+ * Degrades gracefully: events that can not be opened (e.g., in containers,
+ * VMs or due to perf_event_paranoid) are skipped, i.e., read() only reports
+ * available events. Setting the environment variable LH_PERF_COUNTERS=0
+ * disables collection altogether.
+ */
+class Counters {
+ public:
+  Counters() {
+#ifdef __linux__
+    const char* env = std::getenv("LH_PERF_COUNTERS");
+    if (env != nullptr && std::string(env) == "0") return;
+
+    const auto cache_event = [](std::uint64_t cache, std::uint64_t op,
+                                std::uint64_t result) {
+      return cache | (op << 8) | (result << 16);
+    };
+
+    open("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    open("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    open("l1d_misses", PERF_TYPE_HW_CACHE,
+         cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                     PERF_COUNT_HW_CACHE_RESULT_MISS));
+    open("llc_misses", PERF_TYPE_HW_CACHE,
+         cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                     PERF_COUNT_HW_CACHE_RESULT_MISS));
+    open("dtlb_misses", PERF_TYPE_HW_CACHE,
+         cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                     PERF_COUNT_HW_CACHE_RESULT_MISS));
+    open("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+  }
+
+  ~Counters() {
+#ifdef __linux__
+    for (const auto& event : events) close(event.second);
+#endif
+  }
+
+  Counters(const Counters&) = delete;
+  Counters& operator=(const Counters&) = delete;
+
+  bool available() const { return !events.empty(); }
+
+  /// resets and starts all counters
+  void start() {
+#ifdef __linux__
+    for (const auto& event : events) {
+      ioctl(event.second, PERF_EVENT_IOC_RESET, 0);
+      ioctl(event.second, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  void stop() {
+#ifdef __linux__
+    for (const auto& event : events)
+      ioctl(event.second, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+  }
+
+  /**
+   * counter values since the last start(). Values are extrapolated if the
+   * kernel had to multiplex counters
+   */
+  std::vector<std::pair<std::string, double>> read() const {
+    std::vector<std::pair<std::string, double>> values;
+#ifdef __linux__
+    for (const auto& [name, fd] : events) {
+      // value, time enabled, time running
+      std::uint64_t buffer[3] = {0, 0, 0};
+      if (::read(fd, buffer, sizeof(buffer)) != sizeof(buffer)) continue;
+      if (buffer[2] == 0) continue;
+
+      values.emplace_back(name, static_cast<double>(buffer[0]) *
+                                    static_cast<double>(buffer[1]) /
+                                    static_cast<double>(buffer[2]));
+    }
+#endif
+    return values;
+  }
+
+ private:
+  /// (name, file descriptor) of each successfully opened event
+  std::vector<std::pair<std::string, int>> events;
+
+#ifdef __linux__
+  void open(const std::string& name, std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd >= 0) events.emplace_back(name, fd);
+  }
+#endif
+};
+}  // namespace perf
@@ -1,8 +1,24 @@
 #include <gtest/gtest.h>
 
+#include "tests/allocator-tests.hpp"
+#include "tests/auto-tests.hpp"
+#include "tests/chained-table-tests.hpp"
 #include "tests/cht-tests.hpp"
+#include "tests/cuckoo-table-tests.hpp"
+#include "tests/drift-tests.hpp"
 #include "tests/dynamic-pgm-tests.hpp"
+#include "tests/encoded-tests.hpp"
+#include "tests/hybrid-tests.hpp"
+#include "tests/monotone-table-tests.hpp"
+#include "tests/partition-tests.hpp"
 #include "tests/pgm-tests.hpp"
+#include "tests/quality-tests.hpp"
 #include "tests/rmi-tests.hpp"
 #include "tests/rs-tests.hpp"
+#include "tests/search-tests.hpp"
+#include "tests/sort-tests.hpp"
+#include "tests/string-tests.hpp"
 #include "tests/ts-tests.hpp"
+#include "tests/uint128-tests.hpp"
+#include "tests/uint32-tests.hpp"
+#include "tests/versioned-tests.hpp"
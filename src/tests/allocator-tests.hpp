@@ -0,0 +1,66 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <limits>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+TEST(HugePageAllocator, LargeAllocationsAreHugePageAligned) {
+  using Allocator = learned_hashing::HugePageAllocator<std::uint64_t>;
+  Allocator alloc;
+
+  // small allocations are served by the default allocator
+  auto small = alloc.allocate(16);
+  small[15] = 42;
+  alloc.deallocate(small, 16);
+
+  const size_t n = 3 * Allocator::huge_page_size / sizeof(std::uint64_t);
+  auto large = alloc.allocate(n);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) %
+                Allocator::huge_page_size,
+            0);
+  large[n - 1] = 42;
+  alloc.deallocate(large, n);
+}
+
+/// Allocators must only affect memory placement, not hash values
+TEST(HugePageAllocator, HashValuesMatchDefaultAllocator) {
+  using Data = std::uint64_t;
+  using Allocator = learned_hashing::HugePageAllocator<Data, -1, 0>;
+
+  const auto dataset = dataset::load_cached(dataset::ID::NORMAL, 100000);
+
+  const auto expect_equal_hashes = [&](const auto& expected, const auto& fn) {
+    for (const auto& key : dataset) EXPECT_EQ(fn(key), expected(key));
+  };
+
+  expect_equal_hashes(
+      learned_hashing::RMIHash<Data, 1000>(dataset.begin(), dataset.end(),
+                                           dataset.size()),
+      learned_hashing::RMIHash<Data, 1000, 2, double,
+                               learned_hashing::LinearImpl<Data, double>,
+                               learned_hashing::LinearImpl<Data, double>,
+                               Allocator>(dataset.begin(), dataset.end(),
+                                          dataset.size()));
+  expect_equal_hashes(
+      learned_hashing::RadixSplineHash<Data, 18, 4>(
+          dataset.begin(), dataset.end(), dataset.size()),
+      learned_hashing::RadixSplineHash<
+          Data, 18, 4, std::numeric_limits<size_t>::max(),
+          learned_hashing::_rs::SplineLayout::BTree, Allocator>(
+          dataset.begin(), dataset.end(), dataset.size()));
+  expect_equal_hashes(
+      learned_hashing::TrieSplineHash<Data, 4>(dataset.begin(), dataset.end(),
+                                               dataset.size()),
+      learned_hashing::TrieSplineHash<Data, 4, Allocator>(
+          dataset.begin(), dataset.end(), dataset.size()));
+  expect_equal_hashes(
+      learned_hashing::CHTHash<Data, 4>(dataset.begin(), dataset.end(),
+                                        dataset.size()),
+      learned_hashing::CHTHash<Data, 4, 64, Allocator>(
+          dataset.begin(), dataset.end(), dataset.size()));
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+TEST(AutoLearnedHash, RespectsByteBudget) {
+  using Data = std::uint64_t;
+  const auto dataset = dataset::load_cached(dataset::ID::NORMAL, 200000);
+
+  learned_hashing::AutoTuneOptions options;
+  options.byte_budget = 64 * 1024;
+  options.subsample_size = 50000;
+  const learned_hashing::AutoLearnedHash<Data> fn(
+      dataset.begin(), dataset.end(), dataset.size(), options);
+
+  const auto& report = fn.tuning_report();
+  ASSERT_EQ(report.candidates.size(),
+            std::tuple_size_v<learned_hashing::DefaultAutoCandidates<Data>>);
+  const auto& selected = report.candidates[report.selected];
+  EXPECT_TRUE(selected.within_budget);
+  EXPECT_EQ(selected.name, fn.selected_name());
+  EXPECT_LE(fn.byte_size(), 2 * options.byte_budget);
+  EXPECT_GT(report.tuning_time.count(), 0);
+
+  for (const auto& key : dataset) EXPECT_LT(fn(key), dataset.size());
+}
+
+TEST(AutoLearnedHash, DeterministicSelection) {
+  using Data = std::uint64_t;
+  const auto dataset = dataset::load_cached(dataset::ID::GAPPED_10, 200000);
+
+  for (const auto metric : {learned_hashing::AutoTuneOptions::Metric::Latency,
+                            learned_hashing::AutoTuneOptions::Metric::
+                                Collisions}) {
+    learned_hashing::AutoTuneOptions options;
+    options.metric = metric;
+    options.measure = false;
+    options.subsample_size = 50000;
+    options.time_budget = std::chrono::milliseconds::max();
+
+    const learned_hashing::AutoLearnedHash<Data> a(
+        dataset.begin(), dataset.end(), dataset.size(), options);
+    const learned_hashing::AutoLearnedHash<Data> b(
+        dataset.begin(), dataset.end(), dataset.size(), options);
+
+    EXPECT_EQ(a.tuning_report().selected, b.tuning_report().selected);
+    EXPECT_EQ(a.selected_name(), b.selected_name());
+    for (size_t i = 0; i < dataset.size(); i += 97)
+      EXPECT_EQ(a(dataset[i]), b(dataset[i]));
+  }
+}
+
+TEST(AutoLearnedHash, CollisionMetricPicksFewestCollisions) {
+  using Data = std::uint64_t;
+  const auto dataset = dataset::load_cached(dataset::ID::UNIFORM, 200000);
+
+  learned_hashing::AutoTuneOptions options;
+  options.metric = learned_hashing::AutoTuneOptions::Metric::Collisions;
+  options.subsample_size = 50000;
+  options.time_budget = std::chrono::milliseconds::max();
+  const learned_hashing::AutoLearnedHash<Data> fn(
+      dataset.begin(), dataset.end(), dataset.size(), options);
+
+  const auto& report = fn.tuning_report();
+  for (const auto& candidate : report.candidates) {
+    EXPECT_TRUE(candidate.evaluated);
+    EXPECT_LE(report.candidates[report.selected].collision_rate,
+              candidate.collision_rate);
+  }
+}
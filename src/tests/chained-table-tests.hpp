@@ -0,0 +1,78 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <vector>
+
+#include "../support/datasets.hpp"
+#include "table-test-helpers.hpp"
+
+template <class Hashfn, class Allocator = std::allocator<std::uint64_t>>
+static void test_chained_table(const dataset::ID did,
+                               const double load_factor) {
+  using Key = table_tests::Key;
+  using Table =
+      learned_hashing::ChainedHashTable<Key, std::uint32_t, Hashfn, Allocator>;
+  const auto payload_of = [](const Key& key) {
+    return static_cast<std::uint32_t>(key * 3);
+  };
+
+  const auto keys = table_tests::load_keys(did);
+  const auto& shuffled = keys.shuffled;
+  Table table(keys.sample.begin(), keys.sample.end(),
+              keys.sorted.size() / load_factor);
+
+  // first half one by one, second half batched
+  const size_t half = shuffled.size() / 2;
+  table_tests::insert_keys(
+      table, std::vector<Key>(shuffled.begin(), shuffled.begin() + half),
+      payload_of);
+  std::vector<std::uint32_t> payloads;
+  for (const auto& key : shuffled) payloads.push_back(payload_of(key));
+  EXPECT_EQ(table.insert_batch(shuffled.begin() + half, shuffled.end(),
+                               payloads.begin() + half),
+            shuffled.size() - half);
+  EXPECT_EQ(table.insert_batch(shuffled.begin(), shuffled.end(),
+                               payloads.begin()),
+            0);
+  EXPECT_EQ(table.size(), shuffled.size());
+  EXPECT_LE(table.chained_count(), shuffled.size());
+  EXPECT_NEAR(table.load_factor(), load_factor, 0.01);
+
+  table_tests::expect_lookups(table, keys.sorted, payload_of);
+  table_tests::expect_batched_lookups(table, shuffled);
+}
+
+TEST(ChainedHashTable, FindsKeysAtAnyLoadFactor) {
+  using Key = table_tests::Key;
+  for (const auto did : {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10,
+                         dataset::ID::UNIFORM, dataset::ID::NORMAL}) {
+    for (const double load_factor : {0.5, 1.0, 4.0}) {
+      test_chained_table<learned_hashing::RMIHash<Key, 1000>>(did,
+                                                              load_factor);
+      test_chained_table<learned_hashing::RadixSplineHash<Key, 18, 16>>(
+          did, load_factor);
+    }
+  }
+  test_chained_table<learned_hashing::RMIHash<Key, 1000>,
+                     learned_hashing::HugePageAllocator<Key>>(
+      dataset::ID::NORMAL, 1.0);
+}
+
+TEST(ChainedHashTable, ChainsAllKeysOfOneBucket) {
+  using Key = table_tests::Key;
+  const auto payload_of = [](const Key& key) { return key + 1; };
+
+  const auto keys = table_tests::load_keys(dataset::ID::UNIFORM, 10000);
+  learned_hashing::ChainedHashTable<Key, Key,
+                                    learned_hashing::RMIHash<Key, 100>>
+      table(keys.sample.begin(), keys.sample.end(), 1);
+  table_tests::insert_keys(table, keys.shuffled, payload_of);
+
+  EXPECT_EQ(table.chained_count(), keys.sorted.size() - 1);
+  EXPECT_EQ(table.max_chain_length(), keys.sorted.size());
+  table_tests::expect_lookups(table, keys.sorted, payload_of);
+  table_tests::expect_batched_lookups(table, keys.shuffled);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <string>
+#include <vector>
+
+#include "../support/datasets.hpp"
+#include "table-test-helpers.hpp"
+
+template <class Hashfn>
+static void test_cuckoo_table(const dataset::ID did, const double load_factor) {
+  using Key = table_tests::Key;
+  using Table = learned_hashing::CuckooHashTable<Key, std::uint64_t, Hashfn>;
+  const auto payload_of = [](const Key& key) { return key * 3; };
+
+  const auto keys = table_tests::load_keys(did);
+  Table table(keys.sample.begin(), keys.sample.end(),
+              keys.sorted.size() / load_factor);
+  table_tests::insert_keys(table, keys.shuffled, payload_of);
+  EXPECT_GE(table.load_factor(), load_factor - 0.01) << Table::name();
+  EXPECT_LE(table.stash_size(), 8) << Table::name();
+
+  table_tests::expect_lookups(table, keys.sorted, payload_of);
+  table_tests::expect_batched_lookups(table, keys.shuffled);
+}
+
+TEST(CuckooHashTable, FindsKeysAtHighLoad) {
+  using Key = std::uint64_t;
+  for (const auto did : {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10,
+                         dataset::ID::UNIFORM, dataset::ID::NORMAL}) {
+    test_cuckoo_table<learned_hashing::RMIHash<Key, 1000>>(did, 0.97);
+    test_cuckoo_table<learned_hashing::RadixSplineHash<Key, 18, 16>>(did,
+                                                                     0.97);
+  }
+}
+
+/// maps all keys to bucket 0, i.e., degenerates to single choice hashing
+struct ConstantHash {
+  ConstantHash() = default;
+  template <class It>
+  ConstantHash(const It&, const It&, size_t) {}
+
+  size_t operator()(const std::uint64_t&) const { return 0; }
+
+  static std::string name() { return "constant"; }
+  size_t byte_size() const { return sizeof(*this); }
+};
+
+TEST(CuckooHashTable, StashesHomelessKeys) {
+  using Key = table_tests::Key;
+  const auto payload_of = [](const Key& key) { return key + 1; };
+
+  const auto keys = table_tests::load_keys(dataset::ID::UNIFORM, 10000);
+  learned_hashing::CuckooHashTable<Key, Key, ConstantHash> table(
+      keys.sample.begin(), keys.sample.end(), keys.sorted.size());
+  table_tests::insert_keys(table, keys.shuffled, payload_of);
+
+  EXPECT_GT(table.stash_size(), 0);
+  EXPECT_GT(table.displacement_count(), 0);
+  table_tests::expect_lookups(table, keys.sorted, payload_of);
+  table_tests::expect_batched_lookups(table, keys.shuffled);
+}
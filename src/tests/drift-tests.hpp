@@ -0,0 +1,103 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <random>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+template <class Hashfn>
+static void ExpectNoDriftOnTrainingDistribution() {
+  for (const auto did : {dataset::ID::SEQUENTIAL, dataset::ID::UNIFORM,
+                         dataset::ID::NORMAL}) {
+    const auto dataset = dataset::load_cached<std::uint64_t>(did, 1000000);
+
+    // 1% sample, keys drawn from the same distribution
+    std::vector<std::uint64_t> sample;
+    for (size_t i = 0; i < dataset.size(); i += 100)
+      sample.push_back(dataset[i]);
+    const learned_hashing::MonitoredHash<Hashfn> fn(
+        sample.begin(), sample.end(), dataset.size());
+    for (const auto& key : dataset) fn(key);
+
+    const auto stats = fn.drift_stats();
+    EXPECT_GT(stats.sampled, dataset.size() / 128) << dataset::name(did);
+    EXPECT_LT(stats.kl_divergence, 0.01) << dataset::name(did);
+    EXPECT_FALSE(stats.needs_retrain) << dataset::name(did);
+  }
+}
+
+TEST(DriftMonitor, NoDriftOnTrainingDistribution) {
+  ExpectNoDriftOnTrainingDistribution<
+      learned_hashing::RMIHash<std::uint64_t, 10'000>>();
+  ExpectNoDriftOnTrainingDistribution<
+      learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>();
+}
+
+TEST(DriftMonitor, DetectsDrift) {
+  using RMI = learned_hashing::RMIHash<std::uint64_t, 10'000>;
+  const auto uniform =
+      dataset::load_cached<std::uint64_t>(dataset::ID::UNIFORM, 1000000);
+  const auto normal =
+      dataset::load_cached<std::uint64_t>(dataset::ID::NORMAL, 1000000);
+
+  learned_hashing::MonitoredHash<RMI> fn(uniform.begin(), uniform.end(),
+                                         uniform.size());
+  for (const auto& key : normal) fn(key);
+  EXPECT_TRUE(fn.needs_retrain());
+  EXPECT_GT(fn.drift_stats().kl_divergence, 0.2);
+
+  // retraining on the new keys resets the monitor
+  fn.train(normal.begin(), normal.end(), normal.size());
+  EXPECT_EQ(fn.drift_stats().sampled, 0);
+  for (const auto& key : normal) fn(key);
+  EXPECT_FALSE(fn.needs_retrain());
+}
+
+TEST(DriftMonitor, DetectsPartialDrift) {
+  // 10% of incoming keys fall into a narrow range the model was not trained
+  // on (e.g., a new tenant with sequential ids)
+  const auto uniform =
+      dataset::load_cached<std::uint64_t>(dataset::ID::UNIFORM, 1000000);
+  const learned_hashing::MonitoredHash<
+      learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>
+      fn(uniform.begin(), uniform.end(), uniform.size());
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<std::uint64_t> dist(0, (1ULL << 50) - 1);
+  for (size_t i = 0; i < 1000000; i++)
+    fn(i % 10 == 0 ? (1ULL << 49) + i : dist(rng));
+  const auto stats = fn.drift_stats();
+  EXPECT_TRUE(stats.needs_retrain);
+  EXPECT_GT(stats.max_load, 4.0);
+}
+
+TEST(DriftMonitor, StaysSensitiveAfterLongStableRuns) {
+  // all keys sampled, drift confined to 1/16 of the output range after a
+  // long stable phase
+  const size_t full_size = 1 << 20;
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> dist(0, full_size - 1);
+  const auto run = [&](learned_hashing::DriftMonitor<8, 0>& monitor) {
+    for (size_t i = 0; i < 10'000'000; i++) monitor.record(i, dist(rng));
+    EXPECT_FALSE(monitor.needs_retrain());
+    for (size_t i = 0; i < (1 << 14); i++)
+      monitor.record(i, dist(rng) / 16);
+    return monitor.stats();
+  };
+
+  learned_hashing::DriftMonitor<8, 0> decaying(full_size,
+                                               {.decay_window = 1 << 14});
+  const auto stats = run(decaying);
+  EXPECT_TRUE(stats.needs_retrain);
+  EXPECT_LE(stats.sampled, 2 << 14);
+
+  // without decay, the drift is drowned out by the stable phase
+  learned_hashing::DriftMonitor<8, 0> cumulative(full_size,
+                                                 {.decay_window = 0});
+  EXPECT_FALSE(run(cumulative).needs_retrain);
+}
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <learned_hashing.hpp>
 #include <limits>
+#include <random>
 #include <tuple>
 #include <vector>
 
@@ -36,3 +37,119 @@ TEST(DynamicPGM, IsMonotoneForNonKeys) {
     }
   }
 }
+
+/// hash values have to be exact ranks, independent of how keys were
+/// distributed across levels by trains and inserts
+TEST(DynamicPGM, ComputesRanksAfterInserts) {
+  using Data = std::uint64_t;
+  auto dataset = dataset::load_cached<Data>(dataset::ID::NORMAL, 100000);
+
+  // train on every other key, insert the remaining ones in random order
+  std::vector<Data> trained, inserted;
+  for (size_t i = 0; i < dataset.size(); i++)
+    (i % 2 == 0 ? trained : inserted).push_back(dataset[i]);
+  std::shuffle(inserted.begin(), inserted.end(), std::mt19937_64(42));
+
+  learned_hashing::DynamicPGMHash<Data, 16> pgm(trained.begin(),
+                                                trained.end());
+  std::vector<Data> keys = trained;
+  for (size_t i = 0; i < inserted.size(); i++) {
+    pgm.insert(inserted[i]);
+    // existing keys must not be counted twice
+    pgm.insert(inserted[i / 2]);
+    keys.insert(std::lower_bound(keys.begin(), keys.end(), inserted[i]),
+                inserted[i]);
+
+    if (i % 4999 == 0 || i + 1 == inserted.size()) {
+      ASSERT_EQ(pgm.size(), keys.size());
+      for (size_t j = 0; j < keys.size(); j += 7) {
+        ASSERT_EQ(pgm(keys[j]), j) << i;
+        ASSERT_EQ(pgm(keys[j] + 1), j + 1) << i;
+      }
+    }
+  }
+  EXPECT_EQ(pgm(std::numeric_limits<Data>::max()), keys.size());
+}
+
+TEST(DynamicPGM, InsertsBatches) {
+  using Data = std::uint64_t;
+  const auto dataset = dataset::load_cached<Data>(dataset::ID::UNIFORM, 100000);
+
+  // train on a third, insert the remaining keys in sorted batches of
+  // increasing size that also contain duplicates and existing keys
+  std::vector<Data> trained, remaining;
+  for (size_t i = 0; i < dataset.size(); i++)
+    (i % 3 == 0 ? trained : remaining).push_back(dataset[i]);
+  std::shuffle(remaining.begin(), remaining.end(), std::mt19937_64(42));
+
+  learned_hashing::DynamicPGMHash<Data, 16> pgm(trained.begin(),
+                                                trained.end());
+  for (size_t begin = 0, batch_size = 1; begin < remaining.size();
+       begin += batch_size, batch_size *= 2) {
+    const size_t end = std::min(remaining.size(), begin + batch_size);
+    std::vector<Data> batch(remaining.begin() + begin,
+                            remaining.begin() + end);
+    batch.insert(batch.end(), remaining.begin() + begin,
+                 remaining.begin() + begin + (end - begin + 1) / 2);
+    batch.push_back(trained[begin % trained.size()]);
+    std::sort(batch.begin(), batch.end());
+    pgm.insert_batch(batch.begin(), batch.end());
+  }
+
+  ASSERT_EQ(pgm.size(), dataset.size());
+  for (size_t i = 0; i < dataset.size(); i++) ASSERT_EQ(pgm(dataset[i]), i);
+}
+
+TEST(DynamicPGM, ScalesToGrowingOutputRange) {
+  using Data = std::uint64_t;
+  const auto dataset = dataset::load_cached<Data>(dataset::ID::NORMAL, 100000);
+
+  // keys arrive in random order, the first 1/8 are known at construction
+  auto keys = dataset;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+  std::vector<Data> initial(keys.begin(), keys.begin() + keys.size() / 8);
+  std::sort(initial.begin(), initial.end());
+
+  size_t table_size = initial.size();
+  learned_hashing::ScaledDynamicPGMHash<Data, 16> fn(
+      initial.begin(), initial.end(), table_size);
+  for (size_t i = initial.size(); i < keys.size(); i++) {
+    // hash values are stable until the table grows
+    const auto before = fn(keys[i / 2]);
+    fn.insert(keys[i]);
+    ASSERT_EQ(fn(keys[i / 2]), before);
+    ASSERT_LT(fn(keys[i]), table_size);
+
+    if (i + 1 > table_size) {
+      table_size *= 2;
+      fn.rescale(table_size);
+      ASSERT_EQ(fn.size(), i + 1);
+      ASSERT_EQ(fn.output_size(), table_size);
+    }
+  }
+  fn.rescale(keys.size());
+  EXPECT_EQ(fn.pending_count(), 0);
+
+  // the model knows all keys, i.e., hash values are (scaled) exact ranks
+  const auto report = learned_hashing::quality::evaluate(fn, dataset,
+                                                         dataset.size());
+  EXPECT_LT(static_cast<double>(report.collisions) / dataset.size(), 0.01);
+  for (size_t i = 1; i < dataset.size(); i++)
+    ASSERT_LE(fn(dataset[i - 1]), fn(dataset[i]));
+}
+
+TEST(DynamicPGM, InterpolatesRanks) {
+  using Data = std::uint64_t;
+  const std::vector<Data> trained{10, 20, 30};
+  learned_hashing::DynamicPGMHash<Data, 16> pgm(trained.begin(),
+                                                trained.end());
+  pgm.insert(40);
+
+  EXPECT_DOUBLE_EQ(pgm.interpolated_rank(5), -0.5);
+  EXPECT_DOUBLE_EQ(pgm.interpolated_rank(10), 0);
+  EXPECT_DOUBLE_EQ(pgm.interpolated_rank(15), 0.5);
+  EXPECT_DOUBLE_EQ(pgm.interpolated_rank(30), 2);
+  EXPECT_DOUBLE_EQ(pgm.interpolated_rank(31), 2.1);
+  EXPECT_DOUBLE_EQ(pgm.interpolated_rank(40), 3);
+  EXPECT_DOUBLE_EQ(pgm.interpolated_rank(50), 3.5);
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <limits>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+template <class Float>
+static void ExpectOrderPreservingFloat() {
+  using Traits = learned_hashing::KeyTraits<Float>;
+  using Limits = std::numeric_limits<Float>;
+
+  const std::vector<Float> ordered{-Limits::infinity(),
+                                   Limits::lowest(),
+                                   Float(-1.5),
+                                   -Limits::min(),
+                                   -Limits::denorm_min(),
+                                   Float(0),
+                                   Limits::denorm_min(),
+                                   Limits::min(),
+                                   Float(1),
+                                   Float(1.5),
+                                   Limits::max(),
+                                   Limits::infinity()};
+  for (size_t i = 1; i < ordered.size(); i++)
+    EXPECT_LT(Traits::encode(ordered[i - 1]), Traits::encode(ordered[i]))
+        << ordered[i - 1] << " < " << ordered[i];
+
+  // -0.0 == +0.0, i.e., both have to hash identically
+  EXPECT_EQ(Traits::encode(Float(-0.0)), Traits::encode(Float(0.0)));
+
+  // NaNs are ordered outside of [-inf, inf] depending on their sign bit
+  EXPECT_GT(Traits::encode(Limits::quiet_NaN()),
+            Traits::encode(Limits::infinity()));
+  EXPECT_LT(Traits::encode(-Limits::quiet_NaN()),
+            Traits::encode(-Limits::infinity()));
+  EXPECT_EQ(Traits::encode(Limits::quiet_NaN()),
+            Traits::encode(Limits::quiet_NaN()));
+}
+
+TEST(KeyTraits, OrderPreservingFloats) {
+  ExpectOrderPreservingFloat<float>();
+  ExpectOrderPreservingFloat<double>();
+}
+
+template <class Int>
+static void ExpectOrderPreservingInt() {
+  using Traits = learned_hashing::KeyTraits<Int>;
+  using Limits = std::numeric_limits<Int>;
+
+  const std::vector<Int> ordered{Limits::min(), Limits::min() + 1,
+                                 Int(-1),       Int(0),
+                                 Int(1),        Limits::max()};
+  for (size_t i = 1; i < ordered.size(); i++)
+    EXPECT_LT(Traits::encode(ordered[i - 1]), Traits::encode(ordered[i]));
+  EXPECT_EQ(Traits::encode(Limits::min()), 0);
+  EXPECT_EQ(Traits::encode(Limits::max()),
+            std::numeric_limits<learned_hashing::encoded_key_t<Int>>::max());
+}
+
+TEST(KeyTraits, OrderPreservingInts) {
+  ExpectOrderPreservingInt<std::int32_t>();
+  ExpectOrderPreservingInt<std::int64_t>();
+  EXPECT_EQ(learned_hashing::KeyTraits<std::uint64_t>::encode(42), 42);
+}
+
+/// hashes doubles (timestamps around 0, i.e., both signs) with hashfns over
+/// their 64 bit encoding. Sampled from a normal distribution, i.e., even a
+/// perfect model collides like a random hash (~37%), while a model trained on
+/// a broken (not order preserving) encoding collides on almost all keys
+template <class Hashfn>
+static void ExpectHashesDoubles(const double max_collision_rate = 0.42,
+                                const bool monotone = false) {
+  const auto narrow =
+      dataset::load_cached<std::uint64_t>(dataset::ID::NORMAL, 10000);
+  std::vector<double> keys;
+  for (const auto key : narrow)
+    keys.push_back(static_cast<double>(key) / (1ULL << 40) - 512.0);
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  ASSERT_LT(keys.front(), 0.0);
+  ASSERT_GT(keys.back(), 0.0);
+
+  const learned_hashing::EncodedKeyHash<double, Hashfn> fn(
+      keys.begin(), keys.end(), keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_LT(fn(keys[i]), keys.size()) << Hashfn::name();
+    if (monotone && i > 0) {
+      EXPECT_LE(fn(keys[i - 1]), fn(keys[i])) << Hashfn::name();
+    }
+  }
+
+  // keys outside the sample, including special values, stay in range. PGM
+  // only aims for outputs within [0, N]
+  const double limits = std::numeric_limits<double>::max();
+  for (const double key :
+       {-std::numeric_limits<double>::infinity(), -limits, -0.0, 0.0, limits,
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::quiet_NaN(),
+        -std::numeric_limits<double>::quiet_NaN()})
+    EXPECT_LE(fn(key), keys.size()) << Hashfn::name() << " " << key;
+  EXPECT_EQ(fn(-0.0), fn(0.0));
+
+  const auto report = learned_hashing::quality::evaluate(fn, keys, keys.size());
+  EXPECT_LT(static_cast<double>(report.collisions) / keys.size(),
+            max_collision_rate)
+      << Hashfn::name();
+}
+
+TEST(EncodedKeyHash, HashesDoubles) {
+  using Key = std::uint64_t;
+  ExpectHashesDoubles<learned_hashing::RMIHash<Key, 10'000>>();
+  ExpectHashesDoubles<learned_hashing::RMIHash<
+      Key, 100, 2, double, learned_hashing::RadixImpl<Key, double>>>();
+  ExpectHashesDoubles<learned_hashing::MonotoneRMIHash<Key, 1000>>(0.5, true);
+  ExpectHashesDoubles<learned_hashing::RadixSplineHash<Key, 18, 16>>();
+  ExpectHashesDoubles<learned_hashing::TrieSplineHash<Key, 16>>();
+  ExpectHashesDoubles<learned_hashing::CHTHash<Key, 16>>(0.55);
+  ExpectHashesDoubles<learned_hashing::PGMHash<Key, 16>>();
+  ExpectHashesDoubles<learned_hashing::HybridHash<
+      Key, learned_hashing::RMIHash<Key, 100>>>();
+}
+
+TEST(EncodedKeyHash, HashesSignedInts) {
+  std::vector<std::int32_t> keys;
+  for (std::int32_t key = -50000; key < 50000; key += 7) keys.push_back(key);
+
+  const learned_hashing::EncodedKeyHash<
+      std::int32_t, learned_hashing::RadixSplineHash<std::uint32_t, 18, 16>>
+      fn(keys.begin(), keys.end(), keys.size());
+  const auto report = learned_hashing::quality::evaluate(fn, keys, keys.size());
+  EXPECT_LT(report.collisions, keys.size() / 100);
+}
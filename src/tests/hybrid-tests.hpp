@@ -0,0 +1,71 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <learned_hashing.hpp>
+#include <random>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+TEST(HybridHash, KeepsWellModelledRegions) {
+  using Data = std::uint64_t;
+  using RMI = learned_hashing::RMIHash<Data, 100>;
+  const auto dataset = dataset::load_cached(dataset::ID::SEQUENTIAL, 100000);
+
+  const learned_hashing::HybridHash<Data, RMI> hybrid(
+      dataset.begin(), dataset.end(), dataset.size());
+  const RMI rmi(dataset.begin(), dataset.end(), dataset.size());
+
+  EXPECT_EQ(hybrid.routed_key_fraction(), 0.0);
+  for (const auto& key : dataset) EXPECT_EQ(hybrid(key), rmi(key));
+
+  // sampled keys look random, which must not trigger routing
+  std::vector<Data> sample;
+  std::sample(dataset.begin(), dataset.end(), std::back_inserter(sample),
+              dataset.size() / 100, std::mt19937_64(42));
+  const learned_hashing::HybridHash<Data, RMI> sampled(
+      sample.begin(), sample.end(), dataset.size());
+  EXPECT_EQ(sampled.routed_key_fraction(), 0.0);
+}
+
+TEST(HybridHash, RoutesPoorlyModelledRegions) {
+  using Data = std::uint64_t;
+  using RMI = learned_hashing::RMIHash<Data, 100>;
+
+  // evenly spaced keys followed by uniform random keys spanning a key range
+  // of equal width
+  const size_t n = 100000, stride = 1000;
+  std::vector<Data> keys;
+  for (size_t i = 0; i < n; i++) keys.push_back(i * stride);
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<Data> dist(n * stride, 2 * n * stride - 1);
+  for (size_t i = 0; i < n; i++) keys.push_back(dist(rng));
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  // fewer, larger regions reduce noise in the per region collision rate
+  const learned_hashing::HybridHash<Data, RMI, 8> hybrid(
+      keys.begin(), keys.end(), keys.size());
+  EXPECT_GT(hybrid.routed_key_fraction(), 0.4);
+  EXPECT_LT(hybrid.routed_key_fraction(), 0.6);
+  EXPECT_FALSE(hybrid.routed(hybrid.region(keys.front())));
+  EXPECT_TRUE(hybrid.routed(hybrid.region(keys.back())));
+
+  // routed keys stay within their region's share of the output range
+  for (size_t i = n; i < keys.size(); i++) {
+    EXPECT_GE(hybrid(keys[i]), n - 1);
+    EXPECT_LT(hybrid(keys[i]), keys.size());
+  }
+
+  // on uniform regions, the classical hash collides about as often as the
+  // learned model, i.e., routing saves the model lookup at no cost
+  const RMI rmi(keys.begin(), keys.end(), keys.size());
+  EXPECT_LE(learned_hashing::quality::evaluate(hybrid, keys, keys.size())
+                .collisions,
+            1.05 * learned_hashing::quality::evaluate(rmi, keys, keys.size())
+                       .collisions);
+}
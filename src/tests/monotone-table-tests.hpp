@@ -0,0 +1,91 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <random>
+#include <vector>
+
+#include "../support/datasets.hpp"
+#include "table-test-helpers.hpp"
+
+template <class Hashfn>
+static void test_monotone_table(const dataset::ID did,
+                                const double capacity_factor) {
+  using Key = table_tests::Key;
+  using Table = learned_hashing::MonotoneHashTable<Key, std::uint64_t, Hashfn>;
+  const auto payload_of = [](const Key& key) { return key * 3; };
+
+  const auto test_keys = table_tests::load_keys(did);
+  const auto& keys = test_keys.sorted;
+  Table table(test_keys.sample.begin(), test_keys.sample.end(),
+              keys.size() * capacity_factor);
+  table_tests::insert_keys(table, test_keys.shuffled, payload_of);
+  table_tests::expect_lookups(table, keys, payload_of);
+
+  // ordered iteration
+  std::vector<Key> iterated;
+  for (const auto& [key, payload] : table) {
+    iterated.push_back(key);
+    EXPECT_EQ(payload, payload_of(key));
+  }
+  EXPECT_EQ(iterated, keys) << Table::name();
+
+  // range queries, including non-key bounds
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> dist(0, keys.size() - 1);
+  for (size_t i = 0; i < 1000; i++) {
+    const Key lo = keys[dist(rng)] - (i % 2);
+    const Key hi = lo + (keys.back() - keys.front()) / (1 + i % 1000);
+    const auto first = std::lower_bound(keys.begin(), keys.end(), lo);
+    const auto last = std::lower_bound(keys.begin(), keys.end(), hi);
+
+    std::vector<Key> result;
+    for (const auto& [key, payload] : table.range(lo, hi))
+      result.push_back(key);
+    ASSERT_EQ(result, std::vector<Key>(first, last))
+        << Table::name() << " [" << lo << ", " << hi << ")";
+
+    result.clear();
+    table.range(lo, hi, [&](const Key& key, const std::uint64_t& payload) {
+      EXPECT_EQ(payload, payload_of(key));
+      result.push_back(key);
+    });
+    ASSERT_EQ(result, std::vector<Key>(first, last))
+        << Table::name() << " [" << lo << ", " << hi << ")";
+  }
+}
+
+TEST(MonotoneHashTable, SupportsPointAndRangeQueries) {
+  using Key = std::uint64_t;
+  for (const auto did : {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10,
+                         dataset::ID::UNIFORM, dataset::ID::NORMAL}) {
+    test_monotone_table<learned_hashing::MonotoneRMIHash<Key, 1000>>(did, 1.0);
+    test_monotone_table<learned_hashing::CHTHash<Key, 16>>(did, 1.0);
+    test_monotone_table<learned_hashing::RadixSplineHash<Key, 18, 16>>(did,
+                                                                       1.5);
+  }
+}
+
+TEST(MonotoneHashTable, KeepsOverflowInOrder) {
+  // 16 keys per bucket on average, i.e., most keys overflow
+  test_monotone_table<learned_hashing::TrieSplineHash<std::uint64_t, 16>>(
+      dataset::ID::NORMAL, 1.0 / 16);
+}
+
+TEST(MonotoneHashTable, HandlesLargestKey) {
+  using Key = std::uint64_t;
+  const std::vector<Key> sample{0, 10, 100, ~Key{}};
+  learned_hashing::MonotoneHashTable<
+      Key, int, learned_hashing::RadixSplineHash<Key, 18, 16>>
+      table(sample.begin(), sample.end(), 8);
+  EXPECT_FALSE(table.contains(~Key{}));
+  EXPECT_TRUE(table.insert(~Key{}, 1));
+  EXPECT_TRUE(table.insert(5, 2));
+  EXPECT_TRUE(table.contains(~Key{}));
+  EXPECT_EQ(*table.lookup(~Key{}), 1);
+  EXPECT_FALSE(table.contains(6));
+  EXPECT_EQ(table.range(0, ~Key{}).begin().key(), 5);
+}
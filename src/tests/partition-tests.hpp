@@ -0,0 +1,78 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <random>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+TEST(Partition, IsStableAndComplete) {
+  auto keys = dataset::load_cached<std::uint64_t>(dataset::ID::NORMAL, 100000);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+
+  // 1% sample
+  std::vector<std::uint64_t> sample(keys.begin(), keys.begin() + 1000);
+  std::sort(sample.begin(), sample.end());
+
+  for (const size_t partitions : {1, 7, 64, 1000}) {
+    const learned_hashing::RMIHash<std::uint64_t, 100> fn(
+        sample.begin(), sample.end(), partitions);
+
+    std::vector<std::uint64_t> expected;
+    for (size_t p = 0; p < partitions; p++)
+      for (const auto& key : keys)
+        if (std::min<size_t>(fn(key), partitions - 1) == p)
+          expected.push_back(key);
+
+    for (const size_t threads : {1, 3, 8}) {
+      std::vector<std::uint64_t> out;
+      const auto offsets =
+          learned_hashing::partition_by(fn, keys, partitions, out, threads);
+      ASSERT_EQ(offsets.size(), partitions + 1);
+      EXPECT_EQ(offsets.front(), 0);
+      EXPECT_EQ(offsets.back(), keys.size());
+      EXPECT_EQ(out, expected) << partitions << " " << threads;
+      for (size_t p = 0; p < partitions; p++)
+        for (size_t i = offsets[p]; i < offsets[p + 1]; i++)
+          ASSERT_EQ(std::min<size_t>(fn(out[i]), partitions - 1), p);
+    }
+  }
+}
+
+TEST(Partition, LearnedPartitionsAreBalanced) {
+  for (const auto did : {dataset::ID::GAPPED_10, dataset::ID::UNIFORM,
+                         dataset::ID::NORMAL}) {
+    auto keys = dataset::load_cached<std::uint64_t>(did, 1000000);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+    // 10% sample, i.e., ~400 sample keys per partition
+    std::vector<std::uint64_t> sample(keys.begin(), keys.begin() + 100000);
+    std::sort(sample.begin(), sample.end());
+
+    const size_t partitions = 256;
+    const learned_hashing::RadixSplineHash<std::uint64_t, 18, 16> fn(
+        sample.begin(), sample.end(), keys.size());
+    std::vector<std::uint64_t> out;
+    const auto offsets =
+        learned_hashing::learned_partition(fn, keys, partitions, out);
+
+    const double expected = static_cast<double>(keys.size()) / partitions;
+    for (size_t p = 0; p < partitions; p++) {
+      EXPECT_LT(offsets[p + 1] - offsets[p], 1.25 * expected)
+          << dataset::name(did) << " " << p;
+      EXPECT_GT(offsets[p + 1] - offsets[p], 0.75 * expected)
+          << dataset::name(did) << " " << p;
+    }
+
+    // monotone model, i.e., partitions are ordered
+    for (size_t p = 1; p < partitions; p++)
+      ASSERT_LE(*std::max_element(out.begin() + offsets[p - 1],
+                                  out.begin() + offsets[p]),
+                *std::min_element(out.begin() + offsets[p],
+                                  out.begin() + offsets[p + 1]))
+          << dataset::name(did) << " " << p;
+  }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+TEST(Quality, PerfectHashfn) {
+  using Data = std::uint64_t;
+  std::vector<Data> keys(10000);
+  for (size_t i = 0; i < keys.size(); i++) keys[i] = i;
+
+  const auto report = learned_hashing::quality::evaluate(
+      [](const Data& key) { return key; }, keys, keys.size());
+
+  EXPECT_EQ(report.collisions, 0);
+  EXPECT_EQ(report.empty_slot_fraction, 0.0);
+  EXPECT_EQ(report.max_load, 1);
+  EXPECT_EQ(report.load_p50, 1);
+  EXPECT_EQ(report.load_p999, 1);
+  EXPECT_EQ(report.linear_probing_expected_probes, 1.0);
+  EXPECT_EQ(report.chi_square, 0.0);
+}
+
+TEST(Quality, ConstantHashfn) {
+  using Data = std::uint64_t;
+  std::vector<Data> keys(1000);
+  for (size_t i = 0; i < keys.size(); i++) keys[i] = i;
+
+  // keys all hash to the last slot & wrap around in linear probing
+  const size_t table_size = 2 * keys.size();
+  const auto report = learned_hashing::quality::evaluate(
+      [&](const Data&) { return table_size - 1; }, keys, table_size);
+
+  EXPECT_EQ(report.collisions, keys.size() - 1);
+  EXPECT_EQ(report.empty_slot_fraction,
+            static_cast<double>(table_size - 1) / table_size);
+  EXPECT_EQ(report.max_load, keys.size());
+  EXPECT_EQ(report.load_p50, keys.size());
+  // i-th inserted key needs i probes -> (n + 1) / 2 on average
+  EXPECT_DOUBLE_EQ(report.linear_probing_expected_probes,
+                   (keys.size() + 1) / 2.0);
+  EXPECT_TRUE(std::isinf(learned_hashing::quality::evaluate(
+                             [&](const Data&) { return 0; }, keys, 10)
+                             .linear_probing_expected_probes));
+}
+
+TEST(Quality, ParallelMatchesSequential) {
+  using Data = std::uint64_t;
+  const auto dataset = dataset::load_cached(dataset::ID::NORMAL, 100000);
+  const learned_hashing::RMIHash<Data, 100> rmi(dataset.begin(), dataset.end(),
+                                                dataset.size());
+
+  const auto seq =
+      learned_hashing::quality::evaluate(rmi, dataset, dataset.size(), 1);
+  const auto par =
+      learned_hashing::quality::evaluate(rmi, dataset, dataset.size(), 7);
+
+  EXPECT_EQ(seq.collisions, par.collisions);
+  EXPECT_EQ(seq.empty_slot_fraction, par.empty_slot_fraction);
+  EXPECT_EQ(seq.max_load, par.max_load);
+  EXPECT_EQ(seq.load_p99, par.load_p99);
+  EXPECT_EQ(seq.linear_probing_expected_probes,
+            par.linear_probing_expected_probes);
+  EXPECT_DOUBLE_EQ(seq.chi_square, par.chi_square);
+}
+
+TEST(Quality, ParallelMatchesSequentialOnSkewedHashfns) {
+  using Data = std::uint64_t;
+  std::vector<Data> keys(100000);
+  for (size_t i = 0; i < keys.size(); i++) keys[i] = i;
+
+  const auto expect_matches = [&](const auto& fn, const size_t table_size) {
+    using learned_hashing::quality::evaluate;
+    const auto seq = evaluate(fn, keys, table_size, 1);
+    for (const size_t thread_count : {2, 7, 64}) {
+      const auto par = evaluate(fn, keys, table_size, thread_count);
+      EXPECT_EQ(seq.collisions, par.collisions) << thread_count;
+      EXPECT_EQ(seq.max_load, par.max_load) << thread_count;
+      EXPECT_EQ(seq.load_p99, par.load_p99) << thread_count;
+      EXPECT_EQ(seq.linear_probing_expected_probes,
+                par.linear_probing_expected_probes)
+          << thread_count;
+    }
+  };
+
+  for (const size_t table_size : {keys.size() + keys.size() / 3, keys.size()}) {
+    // hot slots
+    expect_matches([](const Data& key) { return (key * key) % 1000; },
+                   table_size);
+    // runs of collisions spanning threads' slot ranges and wrapping around
+    // the table's end
+    const size_t run_begin = table_size - keys.size() / 10;
+    expect_matches([&](const Data& key) { return run_begin + key / 3; },
+                   table_size);
+    expect_matches([](const Data& key) { return key / 2; }, table_size);
+  }
+}
@@ -65,6 +65,179 @@ TEST(RMI, ConstructionAlgorithmsMatch) {
   }
 }
 
+TEST(RMI, AlternativeRootModelsConstructionAlgorithmsMatch) {
+  using Data = std::uint64_t;
+  using RadixRMI =
+      learned_hashing::RMIHash<Data, 10000, 2, double,
+                               learned_hashing::RadixImpl<Data, double>>;
+  using SplineRMI =
+      learned_hashing::RMIHash<Data, 10000, 2, double,
+                               learned_hashing::LinearSplineImpl<Data, double>>;
+
+  for (const auto dataset_size : {1000, 10000, 1000000}) {
+    for (const auto did : {dataset::ID::SEQUENTIAL, dataset::ID::UNIFORM,
+                           dataset::ID::NORMAL, dataset::ID::GAPPED_10}) {
+      const auto dataset = dataset::load_cached(did, dataset_size);
+
+      const RadixRMI old_radix(dataset.begin(), dataset.end(), dataset_size,
+                               false);
+      const RadixRMI new_radix(dataset.begin(), dataset.end(), dataset_size,
+                               true);
+      EXPECT_EQ(old_radix, new_radix);
+
+      const SplineRMI old_spline(dataset.begin(), dataset.end(), dataset_size,
+                                 false);
+      const SplineRMI new_spline(dataset.begin(), dataset.end(), dataset_size,
+                                 true);
+      EXPECT_EQ(old_spline, new_spline);
+
+      for (const auto& key : dataset) {
+        EXPECT_LT(new_radix(key), dataset_size);
+        EXPECT_LT(new_spline(key), dataset_size);
+      }
+    }
+  }
+}
+
+/// Skewed data should be distributed more evenly across second level models
+/// by the radix & spline root models than by the linear root model
+TEST(RMI, AlternativeRootModelsEvenOccupancyOnSkewed) {
+  using Data = std::uint64_t;
+  const size_t dataset_size = 1000000;
+  const auto dataset = dataset::load_cached(dataset::ID::NORMAL, dataset_size);
+
+  const auto max_occupancy = [&](const auto& rmi) {
+    std::vector<size_t> occ(rmi.model_count() - 1, 0);
+    for (const auto& key : dataset) occ[rmi.second_level_index(key)]++;
+    return *std::max_element(occ.begin(), occ.end());
+  };
+
+  const learned_hashing::RMIHash<Data, 1000> linear_rmi(
+      dataset.begin(), dataset.end(), dataset_size);
+  const learned_hashing::RMIHash<Data, 1000, 2, double,
+                                 learned_hashing::RadixImpl<Data, double>>
+      radix_rmi(dataset.begin(), dataset.end(), dataset_size);
+  const learned_hashing::RMIHash<
+      Data, 1000, 2, double, learned_hashing::LinearSplineImpl<Data, double>>
+      spline_rmi(dataset.begin(), dataset.end(), dataset_size);
+
+  EXPECT_LT(max_occupancy(radix_rmi), max_occupancy(linear_rmi));
+  EXPECT_LT(max_occupancy(spline_rmi), max_occupancy(linear_rmi));
+}
+
+/// checks that rmi.bounds() contains the lower bound position of all keys
+/// and their neighbouring non-keys in the sorted dataset
+template <class RMI, class Data>
+void expect_bounds_hold(const RMI& rmi, const std::vector<Data>& dataset) {
+  for (const auto& k : dataset) {
+    for (const Data key : {k, k - 1, k + 1}) {
+      const size_t pos =
+          std::lower_bound(dataset.begin(), dataset.end(), key) -
+          dataset.begin();
+      const auto bounds = rmi.bounds(key);
+      ASSERT_LE(bounds.begin, pos) << RMI::name() << " " << key;
+      ASSERT_TRUE(pos < bounds.end ||
+                  (pos == dataset.size() && bounds.end == dataset.size()))
+          << RMI::name() << " " << key;
+    }
+  }
+}
+
+TEST(RMI, BoundsHoldAfterMeasuringErrors) {
+  using Data = std::uint64_t;
+  using RadixRMI =
+      learned_hashing::RMIHash<Data, 1000, 2, double,
+                               learned_hashing::RadixImpl<Data, double>>;
+
+  for (const auto did : {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10,
+                         dataset::ID::UNIFORM, dataset::ID::NORMAL}) {
+    auto dataset = dataset::load_cached(did, 100000);
+    std::sort(dataset.begin(), dataset.end());
+
+    // 1% sample
+    std::vector<Data> sample;
+    for (size_t i = 0; i < dataset.size(); i += 100)
+      sample.push_back(dataset[i]);
+
+    learned_hashing::RMIHash<Data, 1000> rmi(sample.begin(), sample.end(),
+                                             dataset.size());
+    rmi.measure_errors(dataset.begin(), dataset.end(), 4);
+    expect_bounds_hold(rmi, dataset);
+
+    RadixRMI radix_rmi(sample.begin(), sample.end(), dataset.size());
+    radix_rmi.measure_errors(dataset.begin(), dataset.end(), 4);
+    expect_bounds_hold(radix_rmi, dataset);
+
+    learned_hashing::RMIHash<Data, 0> root_only(sample.begin(), sample.end(),
+                                                dataset.size());
+    root_only.measure_errors(dataset.begin(), dataset.end());
+    expect_bounds_hold(root_only, dataset);
+  }
+}
+
+TEST(RMI, BoundsHoldWhenTrainedOnAllKeys) {
+  using Data = std::uint64_t;
+  auto dataset = dataset::load_cached(dataset::ID::NORMAL, 100000);
+  std::sort(dataset.begin(), dataset.end());
+
+  learned_hashing::RMIHash<Data, 1000> rmi(dataset.begin(), dataset.end(),
+                                           dataset.size());
+  rmi.measure_errors(dataset.begin(), dataset.end());
+  expect_bounds_hold(rmi, dataset);
+
+  // and tighter than the global error
+  size_t width = 0;
+  for (const auto& key : dataset) {
+    const auto bounds = rmi.bounds(key);
+    width = std::max(width, bounds.end - bounds.begin);
+  }
+  const auto error = rmi.error(dataset[dataset.size() / 2]);
+  EXPECT_LE(error.min, 0);
+  EXPECT_GE(error.max, 0);
+  EXPECT_LT(error.max - error.min + 1, width);
+}
+
+TEST(RMI, ErrorsAreOnlyMeasuredOnRequest) {
+  using Data = std::uint64_t;
+  auto dataset = dataset::load_cached(dataset::ID::UNIFORM, 100000);
+  std::sort(dataset.begin(), dataset.end());
+
+  // training does not record errors, i.e., bounds span the whole range
+  learned_hashing::RMIHash<Data, 1000> rmi(dataset.begin(), dataset.end(),
+                                           dataset.size());
+  const auto untrained_size = rmi.byte_size();
+  EXPECT_EQ(rmi.bounds(dataset[42]).begin, 0);
+  EXPECT_EQ(rmi.bounds(dataset[42]).end, dataset.size());
+
+  rmi.measure_errors(dataset.begin(), dataset.end());
+  EXPECT_GT(rmi.byte_size(), untrained_size);
+  EXPECT_LT(rmi.bounds(dataset[42]).end - rmi.bounds(dataset[42]).begin,
+            dataset.size());
+
+  // retraining discards measured errors
+  rmi.train(dataset.begin(), dataset.end(), dataset.size());
+  EXPECT_EQ(rmi.byte_size(), untrained_size);
+}
+
+TEST(RMI, ParallelErrorMeasurementMatchesSequential) {
+  using Data = std::uint64_t;
+  auto dataset = dataset::load_cached(dataset::ID::UNIFORM, 100000);
+  std::sort(dataset.begin(), dataset.end());
+  std::vector<Data> sample;
+  for (size_t i = 0; i < dataset.size(); i += 100) sample.push_back(dataset[i]);
+
+  learned_hashing::RMIHash<Data, 100> sequential(sample.begin(), sample.end(),
+                                                 dataset.size());
+  auto parallel = sequential;
+  sequential.measure_errors(dataset.begin(), dataset.end(), 1);
+  parallel.measure_errors(dataset.begin(), dataset.end(), 7);
+
+  for (const auto& key : dataset) {
+    EXPECT_EQ(sequential.bounds(key).begin, parallel.bounds(key).begin);
+    EXPECT_EQ(sequential.bounds(key).end, parallel.bounds(key).end);
+  }
+}
+
 // ==== MonotoneRMI ====
 
 TEST(MonotoneRMI, NoCollisionsOnSequential) {
@@ -116,3 +289,19 @@ TEST(MonotoneRMI, IsMonotoneForNonKeys) {
     }
   }
 }
+
+TEST(MonotoneRMI, BoundsHoldAfterMeasuringErrors) {
+  using Data = std::uint64_t;
+  for (const auto did : {dataset::ID::GAPPED_10, dataset::ID::NORMAL}) {
+    auto dataset = dataset::load_cached(did, 100000);
+    std::sort(dataset.begin(), dataset.end());
+    std::vector<Data> sample;
+    for (size_t i = 0; i < dataset.size(); i += 100)
+      sample.push_back(dataset[i]);
+
+    learned_hashing::MonotoneRMIHash<Data, 100> rmi(
+        sample.begin(), sample.end(), dataset.size());
+    rmi.measure_errors(dataset.begin(), dataset.end(), 4);
+    expect_bounds_hold(rmi, dataset);
+  }
+}
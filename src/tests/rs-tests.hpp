@@ -36,3 +36,60 @@ TEST(RadixSpline, IsMonotoneForNonKeys) {
     }
   }
 }
+
+/// Spline layouts must not change the hash values
+TEST(RadixSpline, SplineLayoutsMatch) {
+  using Data = std::uint64_t;
+  using BTreeRS = learned_hashing::RadixSplineHash<
+      Data, 4, 4, std::numeric_limits<size_t>::max(),
+      learned_hashing::_rs::SplineLayout::BTree>;
+  using InterleavedRS = learned_hashing::RadixSplineHash<
+      Data, 4, 4, std::numeric_limits<size_t>::max(),
+      learned_hashing::_rs::SplineLayout::Interleaved>;
+  using SortedRS = learned_hashing::RadixSplineHash<Data, 4, 4>;
+
+  for (const auto did : {dataset::ID::GAPPED_10, dataset::ID::UNIFORM,
+                         dataset::ID::NORMAL}) {
+    const auto dataset = dataset::load_cached(did, 100000);
+
+    const BTreeRS btree_rs(dataset.begin(), dataset.end(), dataset.size());
+    const InterleavedRS interleaved_rs(dataset.begin(), dataset.end(),
+                                       dataset.size());
+    const SortedRS rs(dataset.begin(), dataset.end(), dataset.size());
+
+    EXPECT_EQ(btree_rs.model_count(), rs.model_count());
+    EXPECT_EQ(interleaved_rs.model_count(), rs.model_count());
+    for (const auto& key : dataset) {
+      for (const auto& k : {key, key + 1}) {
+        EXPECT_EQ(btree_rs(k), rs(k));
+        EXPECT_EQ(interleaved_rs(k), rs(k));
+      }
+    }
+  }
+}
+
+TEST(RadixSpline, StaticBTreeLowerBound) {
+  using Data = std::uint64_t;
+
+  for (const size_t size : {1, 7, 8, 9, 64, 65, 1000, 100000}) {
+    const auto dataset = dataset::load_cached(dataset::ID::UNIFORM, size);
+    const learned_hashing::_rs::StaticBTree<Data> btree(dataset);
+
+    EXPECT_EQ(btree.size(), dataset.size());
+    for (const auto& key : dataset) {
+      for (const auto& k : {key - 1, key, key + 1}) {
+        const auto lb = std::lower_bound(dataset.begin(), dataset.end(), k);
+        const size_t pos = std::distance(dataset.begin(), lb);
+        EXPECT_EQ(btree.LowerBound(k), pos);
+
+        // narrowed to ranges around the lower bound of varying width
+        for (const size_t width : {0, 1, 7, 8, 9, 64, 1000}) {
+          const size_t begin = pos - std::min(pos, width / 2);
+          const size_t end = std::min(dataset.size(), pos + width - width / 2);
+          EXPECT_EQ(btree.LowerBound(k, begin, end), pos)
+              << size << " [" << begin << ", " << end << "]";
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <random>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+template <class Hashfn>
+static void test_lower_bound(const bool measure_error) {
+  for (const auto did : {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10,
+                         dataset::ID::UNIFORM, dataset::ID::NORMAL}) {
+    auto data = dataset::load_cached<std::uint64_t>(did, 100000);
+    std::sort(data.begin(), data.end());
+
+    // 1% sample
+    std::vector<std::uint64_t> sample;
+    for (size_t i = 0; i < data.size(); i += 100) sample.push_back(data[i]);
+
+    learned_hashing::SearchableHash<Hashfn> fn(sample.begin(), sample.end(),
+                                               data.size());
+    if (measure_error) fn.measure_error(data);
+
+    std::vector<std::uint64_t> probes{0, data.front(), data.back(),
+                                      data.back() + 1};
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<size_t> dist(0, data.size() - 1);
+    for (size_t i = 0; i < 10000; i++) {
+      const auto key = data[dist(rng)];
+      probes.push_back(key);
+      probes.push_back(key - 1);
+      probes.push_back(key + 1);
+    }
+
+    for (const auto& key : probes) {
+      const size_t expected =
+          std::lower_bound(data.begin(), data.end(), key) - data.begin();
+      ASSERT_EQ(fn.lower_bound(data, key), expected)
+          << Hashfn::name() << " " << dataset::name(did) << " " << key;
+    }
+  }
+}
+
+template <class Hashfn>
+static void test_lower_bound() {
+  test_lower_bound<Hashfn>(true);
+  test_lower_bound<Hashfn>(false);
+}
+
+TEST(SearchableHash, MatchesStdLowerBound) {
+  using Key = std::uint64_t;
+  test_lower_bound<learned_hashing::RadixSplineHash<Key, 18, 16>>();
+  test_lower_bound<learned_hashing::TrieSplineHash<Key, 16>>();
+  test_lower_bound<learned_hashing::CHTHash<Key, 16>>();
+  test_lower_bound<learned_hashing::PGMHash<Key, 16>>();
+  test_lower_bound<learned_hashing::RMIHash<Key, 100>>();
+}
+
+TEST(SearchableHash, MeasuredErrorBoundsMonotoneModels) {
+  auto data = dataset::load_cached<std::uint64_t>(dataset::ID::NORMAL, 100000);
+  std::sort(data.begin(), data.end());
+  std::vector<std::uint64_t> sample;
+  for (size_t i = 0; i < data.size(); i += 100) sample.push_back(data[i]);
+
+  learned_hashing::SearchableHash<
+      learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>
+      fn(sample.begin(), sample.end(), data.size());
+  fn.measure_error(data);
+  EXPECT_LE(fn.min_measured_error(), 0);
+  EXPECT_GE(fn.max_measured_error(), 0);
+
+  for (size_t i = 0; i < data.size(); i++) {
+    for (const auto key : {data[i], data[i] - 1}) {
+      const auto bounds = fn.bounds(key);
+      const size_t pos =
+          std::lower_bound(data.begin(), data.end(), key) - data.begin();
+      ASSERT_LE(bounds.begin, pos);
+      ASSERT_LE(pos, bounds.end);
+    }
+  }
+}
+
+TEST(SearchableHash, HandlesDuplicatesAndEmptyData) {
+  std::vector<std::uint64_t> data;
+  for (std::uint64_t i = 0; i < 10000; i++)
+    for (size_t j = 0; j < 1 + i % 5; j++) data.push_back(i * 3);
+  std::vector<std::uint64_t> sample;
+  for (size_t i = 0; i < data.size(); i += 10) sample.push_back(data[i]);
+
+  learned_hashing::SearchableHash<
+      learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>
+      fn(sample.begin(), sample.end(), data.size());
+  fn.measure_error(data);
+  for (std::uint64_t key = 0; key < 30010; key++)
+    ASSERT_EQ(fn.lower_bound(data, key),
+              std::lower_bound(data.begin(), data.end(), key) - data.begin());
+
+  EXPECT_EQ(fn.lower_bound(std::vector<std::uint64_t>{}, 42), 0);
+}
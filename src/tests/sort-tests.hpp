@@ -0,0 +1,60 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <random>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+TEST(LearnedSort, SortsDatasets) {
+  for (const auto did :
+       {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10, dataset::ID::UNIFORM,
+        dataset::ID::NORMAL}) {
+    auto keys = dataset::load_cached<std::uint64_t>(did, 1000000);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+    auto expected = keys;
+    std::sort(expected.begin(), expected.end());
+
+    for (const size_t threads : {1, 4}) {
+      auto sorted = keys;
+      learned_hashing::learned_sort(sorted.begin(), sorted.end(), threads);
+      EXPECT_EQ(sorted, expected) << dataset::name(did) << " " << threads;
+    }
+
+    // non-monotone model
+    auto sorted = keys;
+    learned_hashing::learned_sort<
+        learned_hashing::RMIHash<std::uint64_t, 1000>>(sorted.begin(),
+                                                       sorted.end());
+    EXPECT_EQ(sorted, expected) << dataset::name(did);
+  }
+}
+
+TEST(LearnedSort, SortsDuplicatesAndSmallRanges) {
+  std::mt19937_64 rng(42);
+  for (const size_t n : {0, 1, 2, 100, 4095, 4096, 100000}) {
+    // many duplicates & a heavy hitter
+    std::vector<std::uint64_t> keys;
+    std::uniform_int_distribution<std::uint64_t> dist(0, 999);
+    for (size_t i = 0; i < n; i++) keys.push_back(i % 3 == 0 ? 7 : dist(rng));
+    auto expected = keys;
+    std::sort(expected.begin(), expected.end());
+
+    learned_hashing::learned_sort(keys.begin(), keys.end());
+    EXPECT_EQ(keys, expected) << n;
+  }
+}
+
+TEST(LearnedSort, Sorts32BitKeys) {
+  auto keys = dataset::load_cached<std::uint32_t>(dataset::ID::NORMAL, 100000);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+  auto expected = keys;
+  std::sort(expected.begin(), expected.end());
+
+  learned_hashing::learned_sort(keys.begin(), keys.end());
+  EXPECT_EQ(keys, expected);
+}
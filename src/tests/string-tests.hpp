@@ -0,0 +1,88 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <string>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+TEST(StringLearnedHash, OrderPreservingPrefix) {
+  using RS = learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>;
+  const auto urls = dataset::generate_strings(dataset::StringID::URL, 10000);
+
+  const learned_hashing::StringLearnedHash<RS> fn(urls.begin(), urls.end(),
+                                                  urls.size());
+  EXPECT_EQ(fn.skipped_bytes(), std::string("https://").size());
+  for (size_t i = 1; i < urls.size(); i++)
+    EXPECT_LE(fn.prefix(urls[i - 1]), fn.prefix(urls[i]));
+
+  // shorter strings precede their extensions, unknown bytes keep order
+  EXPECT_EQ(fn.prefix("https://"), 0);
+  EXPECT_LT(fn.prefix("https://a"), fn.prefix("https://ab"));
+  EXPECT_LT(fn.prefix("https://ab"), fn.prefix("https://b"));
+  EXPECT_LE(fn.prefix("https://b"), fn.prefix("https://b\x80"));
+  EXPECT_LT(fn.prefix("https://b\x80"), fn.prefix("https://c"));
+
+  // ids only use digits past "user:", i.e., they fit entirely into the prefix
+  const auto ids = dataset::generate_strings(dataset::StringID::ID, 10000);
+  const learned_hashing::StringLearnedHash<RS> id_fn(ids.begin(), ids.end(),
+                                                     ids.size());
+  EXPECT_EQ(id_fn.skipped_bytes(), std::string("user:").size());
+  EXPECT_GE(id_fn.prefix_width(), ids.front().size() - 5);
+
+  // keys fitting into the prefix are ordered
+  std::vector<std::string> short_keys;
+  for (size_t i = 0; i < 5000; i++)
+    short_keys.push_back("key-" + std::to_string(1000 + i));
+  std::sort(short_keys.begin(), short_keys.end());
+  const learned_hashing::StringLearnedHash<
+      learned_hashing::MonotoneRMIHash<std::uint64_t, 100>>
+      monotone(short_keys.begin(), short_keys.end(), short_keys.size());
+  for (size_t i = 1; i < short_keys.size(); i++)
+    EXPECT_LE(monotone(short_keys[i - 1]), monotone(short_keys[i]));
+}
+
+TEST(StringLearnedHash, SpreadsPrefixTies) {
+  using RS = learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>;
+  const auto urls = dataset::generate_strings(dataset::StringID::URL, 100000);
+
+  // urls of the same host tie on their prefix, i.e., without hashing suffixes
+  // each host's urls would collide in a single slot
+  const learned_hashing::StringLearnedHash<RS> fn(urls.begin(), urls.end(),
+                                                  urls.size());
+  const auto report =
+      learned_hashing::quality::evaluate(fn, urls, urls.size());
+  EXPECT_LT(static_cast<double>(report.collisions) / urls.size(), 0.5);
+  for (const auto& url : urls) EXPECT_LT(fn(url), urls.size());
+
+  // a fixed skip behaves like the learned one if they coincide
+  const learned_hashing::StringLearnedHash<RS, 8> fixed(
+      urls.begin(), urls.end(), urls.size());
+  for (size_t i = 0; i < urls.size(); i += 101)
+    EXPECT_EQ(fn(urls[i]), fixed(urls[i]));
+}
+
+TEST(StringLearnedHash, HandlesSamplesWithoutDistinctBytes) {
+  using RS = learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>;
+
+  // nothing follows the learned common prefix, i.e., the alphabet is empty
+  const std::vector<std::string> single{"https://example.com"};
+  const std::vector<std::string> identical(100, "https://example.com");
+  for (const auto* sample : {&single, &identical}) {
+    const learned_hashing::StringLearnedHash<RS> rs(
+        sample->begin(), sample->end(), sample->size());
+    EXPECT_EQ(rs.skipped_bytes(), sample->front().size());
+    EXPECT_GT(rs.prefix_width(), 0);
+
+    // end of string still precedes any byte, unknown bytes keep order
+    const auto& key = sample->front();
+    EXPECT_EQ(rs.prefix(key), 0);
+    EXPECT_LT(rs.prefix(key), rs.prefix(key + '\x01'));
+    EXPECT_LE(rs.prefix(key + 'a'), rs.prefix(key + 'b'));
+    EXPECT_LE(rs(key), sample->size());
+  }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+/// shared scaffolding of the hash table tests (monotone, cuckoo, chained)
+namespace table_tests {
+using Key = std::uint64_t;
+
+struct Keys {
+  /// sorted, distinct keys
+  std::vector<Key> sorted;
+  /// sorted 10% sample of the keys to train hash functions on
+  std::vector<Key> sample;
+  /// keys in (deterministic) random insertion order
+  std::vector<Key> shuffled;
+};
+
+inline Keys load_keys(const dataset::ID did, const size_t size = 100000) {
+  Keys keys;
+  keys.sorted = dataset::load_cached<Key>(did, size);
+  std::sort(keys.sorted.begin(), keys.sorted.end());
+  keys.sorted.erase(std::unique(keys.sorted.begin(), keys.sorted.end()),
+                    keys.sorted.end());
+
+  for (size_t i = 0; i < keys.sorted.size(); i += 10)
+    keys.sample.push_back(keys.sorted[i]);
+
+  keys.shuffled = keys.sorted;
+  std::shuffle(keys.shuffled.begin(), keys.shuffled.end(),
+               std::mt19937_64(42));
+  return keys;
+}
+
+/// inserts all keys with payload(key), then expects inserting them again to
+/// fail, i.e., duplicates to be rejected
+template <class Table, class PayloadFn>
+void insert_keys(Table& table, const std::vector<Key>& keys,
+                 const PayloadFn& payload) {
+  for (const auto& key : keys) {
+    ASSERT_TRUE(table.insert(key, payload(key)))
+        << Table::name() << " " << key;
+  }
+  for (const auto& key : keys) {
+    ASSERT_FALSE(table.insert(key, payload(key)))
+        << Table::name() << " " << key;
+  }
+  EXPECT_EQ(table.size(), keys.size()) << Table::name();
+}
+
+/// expects lookups of all (sorted) keys to yield payload(key) and lookups of
+/// non-keys in the gaps between them to fail
+template <class Table, class PayloadFn>
+void expect_lookups(const Table& table, const std::vector<Key>& sorted_keys,
+                    const PayloadFn& payload) {
+  for (const auto& key : sorted_keys) {
+    const auto* p = table.lookup(key);
+    ASSERT_NE(p, nullptr) << Table::name() << " " << key;
+    EXPECT_EQ(*p, payload(key)) << Table::name() << " " << key;
+  }
+  for (size_t i = 1; i < sorted_keys.size(); i++) {
+    if (sorted_keys[i - 1] + 1 < sorted_keys[i]) {
+      EXPECT_FALSE(table.contains(sorted_keys[i] - 1))
+          << Table::name() << " " << sorted_keys[i] - 1;
+    }
+  }
+}
+
+/// expects lookup_batch() to match lookup() on a mix of keys and non-keys
+template <class Table>
+void expect_batched_lookups(const Table& table, const std::vector<Key>& keys) {
+  std::vector<Key> probes;
+  for (size_t i = 0; i < std::min<size_t>(keys.size(), 1000); i++)
+    probes.push_back(keys[i] + i % 2);
+
+  std::vector<decltype(table.lookup(Key{}))> results;
+  table.lookup_batch(probes.begin(), probes.end(),
+                     std::back_inserter(results));
+  ASSERT_EQ(results.size(), probes.size()) << Table::name();
+  for (size_t i = 0; i < probes.size(); i++) {
+    EXPECT_EQ(results[i], table.lookup(probes[i]))
+        << Table::name() << " " << probes[i];
+  }
+}
+}  // namespace table_tests
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <vector>
+
+#include "../support/datasets.hpp"
+#include "../support/probing_set.hpp"
+
+using Uint128 = unsigned __int128;
+
+TEST(Uint128, GeneratedDatasets) {
+  for (const auto did :
+       {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10, dataset::ID::UNIFORM,
+        dataset::ID::NORMAL}) {
+    const auto dataset = dataset::load_cached<Uint128>(did, 100000);
+    const auto narrow = dataset::load_cached<std::uint64_t>(did, 100000);
+
+    ASSERT_EQ(dataset.size(), narrow.size()) << dataset::name(did);
+    EXPECT_TRUE(std::is_sorted(dataset.begin(), dataset.end()));
+    for (size_t i = 0; i < dataset.size(); i++)
+      EXPECT_EQ(static_cast<std::uint64_t>(dataset[i] >> 64), narrow[i]);
+
+    const auto probing_set = dataset::generate_probing_set(
+        dataset, dataset::ProbingDistribution::EXPONENTIAL);
+    EXPECT_EQ(probing_set.size(), dataset.size());
+  }
+}
+
+/// 128 bit keys far apart from zero are only distinguishable in their low
+/// bits, i.e., models must not convert keys to floating point directly
+template <class Hashfn>
+static void ExpectResolvesLowBits() {
+  // (tenant, id) keys of a single tenant with consecutive ids
+  const Uint128 tenant = 0xDEADBEEF;
+  std::vector<Uint128> keys;
+  for (std::uint64_t id = 0; id < 100000; id++)
+    keys.push_back((tenant << 96) | (static_cast<Uint128>(id) << 8));
+
+  const Hashfn fn(keys.begin(), keys.end(), keys.size());
+  const auto report =
+      learned_hashing::quality::evaluate(fn, keys, keys.size());
+  EXPECT_LT(static_cast<double>(report.collisions) / keys.size(), 0.01)
+      << Hashfn::name();
+  for (size_t i = 1; i < keys.size(); i++)
+    ASSERT_LE(fn(keys[i - 1]), fn(keys[i])) << Hashfn::name() << " " << i;
+}
+
+TEST(Uint128, ResolvesLowBits) {
+  ExpectResolvesLowBits<learned_hashing::RMIHash<Uint128, 100>>();
+  ExpectResolvesLowBits<learned_hashing::RMIHash<
+      Uint128, 100, 2, double,
+      learned_hashing::RadixImpl<Uint128, double, 12>>>();
+  ExpectResolvesLowBits<learned_hashing::RMIHash<
+      Uint128, 100, 2, double,
+      learned_hashing::LinearSplineImpl<Uint128, double, 64>>>();
+  ExpectResolvesLowBits<learned_hashing::MonotoneRMIHash<Uint128, 100>>();
+  ExpectResolvesLowBits<learned_hashing::RadixSplineHash<Uint128, 18, 16>>();
+  ExpectResolvesLowBits<learned_hashing::RadixSplineHash<
+      Uint128, 18, 16, std::numeric_limits<size_t>::max(),
+      learned_hashing::_rs::SplineLayout::BTree>>();
+}
+
+/// widened datasets have the same cdf, i.e., models should be as good
+template <class Hashfn128, class Hashfn64>
+static void ExpectMatchesQuality64Bit() {
+  const auto keys = dataset::load_cached<Uint128>(dataset::ID::NORMAL, 100000);
+  const auto narrow =
+      dataset::load_cached<std::uint64_t>(dataset::ID::NORMAL, 100000);
+
+  const Hashfn128 fn128(keys.begin(), keys.end(), keys.size());
+  const Hashfn64 fn64(narrow.begin(), narrow.end(), narrow.size());
+  const auto collisions128 =
+      learned_hashing::quality::evaluate(fn128, keys, keys.size()).collisions;
+  const auto collisions64 =
+      learned_hashing::quality::evaluate(fn64, narrow, narrow.size())
+          .collisions;
+  EXPECT_LE(collisions128, collisions64 * 1.01 + 10) << Hashfn128::name();
+}
+
+TEST(Uint128, MatchesQuality64Bit) {
+  ExpectMatchesQuality64Bit<learned_hashing::RMIHash<Uint128, 1000>,
+                            learned_hashing::RMIHash<std::uint64_t, 1000>>();
+  ExpectMatchesQuality64Bit<
+      learned_hashing::MonotoneRMIHash<Uint128, 1000>,
+      learned_hashing::MonotoneRMIHash<std::uint64_t, 1000>>();
+  ExpectMatchesQuality64Bit<
+      learned_hashing::RadixSplineHash<Uint128, 18, 16>,
+      learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>>();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <limits>
+#include <vector>
+
+#include "../support/datasets.hpp"
+#include "../support/probing_set.hpp"
+
+TEST(Uint32, GeneratedDatasets) {
+  using Data = std::uint32_t;
+  for (const auto did :
+       {dataset::ID::SEQUENTIAL, dataset::ID::GAPPED_10, dataset::ID::UNIFORM,
+        dataset::ID::NORMAL}) {
+    const auto dataset = dataset::load_cached<Data>(did, 100000);
+
+    // uniform keys may collide in the 32 bit key space -> deduplicated
+    EXPECT_GT(dataset.size(), 99000) << dataset::name(did);
+    EXPECT_TRUE(std::is_sorted(dataset.begin(), dataset.end()));
+    EXPECT_EQ(std::adjacent_find(dataset.begin(), dataset.end()),
+              dataset.end());
+    EXPECT_LT(dataset.back(), std::numeric_limits<Data>::max());
+
+    const auto probing_set = dataset::generate_probing_set(
+        dataset, dataset::ProbingDistribution::EXPONENTIAL);
+    EXPECT_EQ(probing_set.size(), dataset.size());
+  }
+}
+
+/// 32 bit keys must hash exactly like the same keys stored in 64 bits
+template <template <class> class Hashfn>
+static void ExpectMatches64Bit() {
+  const auto keys32 =
+      dataset::load_cached<std::uint32_t>(dataset::ID::UNIFORM, 100000);
+  const std::vector<std::uint64_t> keys64(keys32.begin(), keys32.end());
+
+  const Hashfn<std::uint32_t> fn32(keys32.begin(), keys32.end(),
+                                   keys32.size());
+  const Hashfn<std::uint64_t> fn64(keys64.begin(), keys64.end(),
+                                   keys64.size());
+
+  for (size_t i = 0; i < keys32.size(); i++) {
+    EXPECT_EQ(fn32(keys32[i]), fn64(keys64[i]))
+        << Hashfn<std::uint32_t>::name();
+    EXPECT_LT(fn32(keys32[i]), keys32.size());
+  }
+}
+
+template <class Key>
+using RMI32 = learned_hashing::RMIHash<Key, 1000>;
+template <class Key>
+using MonotoneRMI32 = learned_hashing::MonotoneRMIHash<Key, 1000>;
+template <class Key>
+using RS32 = learned_hashing::RadixSplineHash<Key, 18, 16>;
+template <class Key>
+using RSBTree32 =
+    learned_hashing::RadixSplineHash<Key, 18, 16,
+                                     std::numeric_limits<size_t>::max(),
+                                     learned_hashing::_rs::SplineLayout::BTree>;
+template <class Key>
+using TS32 = learned_hashing::TrieSplineHash<Key, 16>;
+template <class Key>
+using CHT32 = learned_hashing::CHTHash<Key, 16>;
+template <class Key>
+using PGM32 = learned_hashing::PGMHash<Key, 16>;
+
+TEST(Uint32, HashfnsMatch64Bit) {
+  ExpectMatches64Bit<RMI32>();
+  ExpectMatches64Bit<MonotoneRMI32>();
+  ExpectMatches64Bit<RS32>();
+  ExpectMatches64Bit<RSBTree32>();
+  ExpectMatches64Bit<TS32>();
+  ExpectMatches64Bit<CHT32>();
+  ExpectMatches64Bit<PGM32>();
+}
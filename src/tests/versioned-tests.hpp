@@ -0,0 +1,115 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <learned_hashing.hpp>
+#include <thread>
+#include <vector>
+
+#include "../support/datasets.hpp"
+
+TEST(VersionedHash, PublishesRetrainedModels) {
+  using RMI = learned_hashing::RMIHash<std::uint64_t, 100>;
+  const auto uniform =
+      dataset::load_cached<std::uint64_t>(dataset::ID::UNIFORM, 10000);
+  const auto normal =
+      dataset::load_cached<std::uint64_t>(dataset::ID::NORMAL, 10000);
+
+  learned_hashing::VersionedHash<RMI> versioned(uniform.begin(), uniform.end(),
+                                                uniform.size());
+  auto reader = versioned.reader();
+  const RMI on_uniform(uniform.begin(), uniform.end(), uniform.size());
+  for (const auto& key : normal) EXPECT_EQ(reader(key), on_uniform(key));
+
+  versioned.retrain(normal.begin(), normal.end(), normal.size());
+  EXPECT_EQ(versioned.version(), 1);
+  const RMI on_normal(normal.begin(), normal.end(), normal.size());
+  for (const auto& key : normal) EXPECT_EQ(reader(key), on_normal(key));
+
+  // no reader is hashing, i.e., the old model was freed right away
+  EXPECT_EQ(versioned.retired_count(), 0);
+}
+
+/// blocks within operator() until released, tracking live instances
+struct BlockingHash {
+  static inline std::atomic<int> live{0};
+  static inline std::atomic<bool> entered{false}, release{false};
+
+  BlockingHash() { live++; }
+  template <class It>
+  BlockingHash(const It&, const It&, const size_t) : BlockingHash() {}
+  ~BlockingHash() { live--; }
+
+  size_t operator()(const std::uint64_t&) const {
+    entered = true;
+    while (!release) std::this_thread::yield();
+    return 0;
+  }
+
+  size_t model_count() const { return 1; }
+  size_t byte_size() const { return sizeof(*this); }
+  static std::string name() { return "blocking"; }
+};
+
+TEST(VersionedHash, DefersReclamationWhileInUse) {
+  {
+    const std::vector<std::uint64_t> sample{1, 2, 3};
+    learned_hashing::VersionedHash<BlockingHash> versioned(
+        sample.begin(), sample.end(), sample.size());
+
+    auto reader = versioned.reader();
+    std::thread hashing([&] { reader(42); });
+    while (!BlockingHash::entered) std::this_thread::yield();
+
+    // the reader still uses the first model
+    versioned.retrain(sample.begin(), sample.end(), sample.size());
+    versioned.retrain(sample.begin(), sample.end(), sample.size());
+    EXPECT_EQ(versioned.retired_count(), 2);
+    EXPECT_EQ(BlockingHash::live, 3);
+
+    BlockingHash::release = true;
+    hashing.join();
+    versioned.reclaim();
+    EXPECT_EQ(versioned.retired_count(), 0);
+    EXPECT_EQ(BlockingHash::live, 1);
+  }
+  EXPECT_EQ(BlockingHash::live, 0);
+}
+
+TEST(VersionedHash, ConcurrentRetraining) {
+  using RS = learned_hashing::RadixSplineHash<std::uint64_t, 18, 16>;
+  const auto uniform =
+      dataset::load_cached<std::uint64_t>(dataset::ID::UNIFORM, 10000);
+  const auto normal =
+      dataset::load_cached<std::uint64_t>(dataset::ID::NORMAL, 10000);
+
+  const size_t full_size = 10000;
+  learned_hashing::VersionedHash<RS> versioned(uniform.begin(), uniform.end(),
+                                               full_size);
+  std::atomic<bool> done{false};
+  std::atomic<size_t> out_of_range{0}, lookups{0};
+  std::vector<std::thread> readers;
+  for (size_t t = 0; t < 3; t++)
+    readers.emplace_back([&, reader = versioned.reader()] {
+      for (size_t i = 0; !done || i < normal.size(); i++) {
+        const auto& key = (i & 1 ? uniform : normal)[i % normal.size()];
+        out_of_range += reader(key) >= full_size;
+        lookups++;
+      }
+    });
+
+  for (size_t round = 0; round < 200; round++) {
+    const auto& sample = round & 1 ? uniform : normal;
+    versioned.retrain(sample.begin(), sample.end(), full_size);
+  }
+  done = true;
+  for (auto& reader : readers) reader.join();
+
+  EXPECT_EQ(versioned.version(), 200);
+  EXPECT_EQ(out_of_range, 0);
+  EXPECT_GE(lookups, 3 * normal.size());
+  versioned.reclaim();
+  EXPECT_EQ(versioned.retired_count(), 0);
+}